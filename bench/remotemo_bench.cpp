@@ -0,0 +1,177 @@
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <remotemo/remotemo.hpp>
+
+// Runs with the dummy video driver and the software renderer so that the
+// numbers depend as little as possible on the machine's graphics stack. The
+// results get written out as JSON (to stdout or to the file given as the
+// first argument) so that they can be compared between commits.
+
+using Clock = std::chrono::steady_clock;
+
+struct Bench_result {
+  std::string name;
+  remotemo::Size grid;
+  int iterations;
+  double total_ms;
+  remotemo::Render_stats stats;
+};
+
+std::optional<remotemo::Remotemo> create_monitor(const remotemo::Size& grid)
+{
+  // Any hints get cleared by SDL_Quit(), so they need to be set every time:
+  ::SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+  ::SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+  remotemo::Config config {};
+  config.text_area_size(grid);
+  auto monitor = remotemo::create(config);
+  if (monitor) {
+    monitor->set_text_delay(0);
+  }
+  return monitor;
+}
+
+double elapsed_ms(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+// Times `iterations` calls to `bench_once` on a freshly created monitor.
+std::optional<Bench_result> run_bench(const std::string& name,
+    const remotemo::Size& grid, int iterations,
+    const std::function<void(remotemo::Remotemo*, int)>& bench_once)
+{
+  auto monitor = create_monitor(grid);
+  if (!monitor) {
+    std::cerr << "Failed to create the monitor for '" << name << "'\n";
+    return {};
+  }
+  monitor->reset_stats();
+  auto start = Clock::now();
+  for (int i = 0; i < iterations; i++) {
+    bench_once(&*monitor, i);
+  }
+  return Bench_result {
+      name, grid, iterations, elapsed_ms(start), monitor->stats()};
+}
+
+std::optional<Bench_result> bench_create(const remotemo::Size& grid)
+{
+  constexpr int iterations = 5;
+  double total_ms = 0.0;
+  for (int i = 0; i < iterations; i++) {
+    auto start = Clock::now();
+    auto monitor = create_monitor(grid);
+    total_ms += elapsed_ms(start);
+    if (!monitor) {
+      std::cerr << "Failed to create the monitor for 'create'\n";
+      return {};
+    }
+  }
+  return Bench_result {"create", grid, iterations, total_ms, {}};
+}
+
+std::vector<std::optional<Bench_result>> bench_grid(
+    const remotemo::Size& grid)
+{
+  const std::string full_screen(
+      static_cast<std::size_t>(grid.width) * grid.height, 'x');
+  std::vector<std::optional<Bench_result>> results {};
+
+  results.push_back(bench_create(grid));
+
+  // Fills the whole text area, one character at a time, without scrolling:
+  constexpr int print_iterations = 10;
+  results.push_back(run_bench("print", grid, print_iterations,
+      [&full_screen](remotemo::Remotemo* monitor, int /*i*/) {
+        monitor->print_at(0, 0, full_screen);
+      }));
+
+  // Every line printed scrolls the whole text area:
+  const int scroll_iterations = grid.height * 4;
+  results.push_back(run_bench("scroll", grid, scroll_iterations,
+      [](remotemo::Remotemo* monitor, int /*i*/) {
+        monitor->print("Scrolling\n");
+      }));
+
+  constexpr int clear_iterations = 20;
+  results.push_back(run_bench("clear", grid, clear_iterations,
+      [](remotemo::Remotemo* monitor, int /*i*/) { monitor->clear(); }));
+
+  // A window event makes the next render redraw the whole text area:
+  constexpr int refresh_iterations = 50;
+  results.push_back(run_bench("refresh_texture", grid, refresh_iterations,
+      [](remotemo::Remotemo* monitor, int /*i*/) {
+        SDL_Event event {};
+        event.type = SDL_WINDOWEVENT;
+        event.window.event = SDL_WINDOWEVENT_EXPOSED;
+        ::SDL_PushEvent(&event);
+        monitor->print_at(0, 0, "x");
+      }));
+
+  constexpr int cursor_iterations = 10'000;
+  results.push_back(run_bench("cursor_move", grid, cursor_iterations,
+      [&grid](remotemo::Remotemo* monitor, int i) {
+        // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
+        monitor->set_cursor((i * 7) % grid.width, (i * 3) % grid.height);
+      }));
+  return results;
+}
+
+void write_json(std::ostream& out, const std::vector<Bench_result>& results)
+{
+  out << "{\n  \"library\": \"" << remotemo::full_name() << "\",\n"
+      << "  \"results\": [";
+  const char* separator = "\n";
+  for (const auto& result : results) {
+    out << separator << "    {\"name\": \"" << result.name << "\""
+        << ", \"columns\": " << result.grid.width
+        << ", \"lines\": " << result.grid.height
+        << ", \"iterations\": " << result.iterations
+        << ", \"total_ms\": " << result.total_ms
+        << ", \"per_iteration_us\": "
+        << (result.total_ms * 1000.0 / result.iterations)
+        << ", \"frames_presented\": " << result.stats.frames_presented
+        << ", \"render_copy_calls\": " << result.stats.render_copy_calls
+        << ", \"render_target_switches\": "
+        << result.stats.render_target_switches
+        << ", \"full_refreshes\": " << result.stats.full_refreshes
+        << ", \"render_ms\": " << result.stats.render_ms << "}";
+    separator = ",\n";
+  }
+  out << "\n  ]\n}\n";
+}
+
+int main(int argc, char* argv[])
+{
+  const std::vector<remotemo::Size> grids {
+      {40, 24}, {80, 25}, {132, 43}, {160, 60}};
+  std::vector<Bench_result> results {};
+  for (const auto& grid : grids) {
+    for (auto& result : bench_grid(grid)) {
+      if (!result) {
+        return 1;
+      }
+      results.push_back(std::move(*result));
+    }
+  }
+
+  if (argc > 1) {
+    std::ofstream out_file {argv[1]};
+    if (!out_file) {
+      std::cerr << "Could not open '" << argv[1] << "' for writing\n";
+      return 1;
+    }
+    write_json(out_file, results);
+  } else {
+    write_json(std::cout, results);
+  }
+  return 0;
+}
@@ -0,0 +1,53 @@
+# Generates a C++ source file containing the given resource files as byte
+# arrays, so that they can be compiled into the library.
+#
+# Run in script mode:
+#   cmake -DRES_ROOT=<dir> "-DRES_FILES=<file;...>" -DOUTPUT=<file.cpp>
+#         -P embed_resources.cmake
+#
+# RES_FILES are relative to RES_ROOT and that relative path is also the name
+# the resource can be found under (see src/embedded_res.hpp).
+
+if(NOT DEFINED RES_ROOT OR NOT DEFINED RES_FILES OR NOT DEFINED OUTPUT)
+    message(FATAL_ERROR "RES_ROOT, RES_FILES and OUTPUT must all be defined")
+endif()
+
+set(content "// Generated by cmake/embed_resources.cmake - DO NOT EDIT\n\n")
+string(APPEND content "#include \"embedded_res.hpp\"\n\n")
+string(APPEND content "namespace remotemo {\nnamespace {\n")
+
+set(table "")
+set(count 0)
+foreach(res_file IN LISTS RES_FILES)
+    file(READ "${RES_ROOT}/${res_file}" hex_content HEX)
+    string(MAKE_C_IDENTIFIER "${res_file}" res_name)
+    string(LENGTH "${hex_content}" hex_length)
+    math(EXPR res_size "${hex_length} / 2")
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," bytes "${hex_content}")
+    # 12 bytes per line (CMake regexes do not support "{n}"):
+    string(REPEAT "0x..," 12 bytes_per_line)
+    string(REGEX REPLACE "(${bytes_per_line})" "\\1\n    " bytes "${bytes}")
+    string(APPEND content
+        "constexpr unsigned char ${res_name}[${res_size}] {\n    ${bytes}\n};\n"
+    )
+    string(APPEND table
+        "    {\"${res_file}\", &${res_name}[0], sizeof(${res_name})},\n"
+    )
+    math(EXPR count "${count} + 1")
+endforeach()
+
+string(APPEND content "} // namespace\n\n")
+string(APPEND content
+    "extern const Embedded_res embedded_res_table[];\n"
+    "extern const std::size_t embedded_res_count;\n\n"
+    "const Embedded_res embedded_res_table[] {\n${table}};\n"
+    "const std::size_t embedded_res_count {${count}};\n"
+)
+string(APPEND content "} // namespace remotemo\n")
+
+# Only touch the output if the content did change:
+file(WRITE "${OUTPUT}.tmp" "${content}")
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different
+    "${OUTPUT}.tmp" "${OUTPUT}"
+)
+file(REMOVE "${OUTPUT}.tmp")
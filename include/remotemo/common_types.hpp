@@ -8,6 +8,10 @@
 #define REMOTEMO_COMMON_TYPES_HPP
 
 #include <string>
+#include <optional>
+#include <array>
+#include <cstddef>
+#include <vector>
 #include <SDL.h>
 
 namespace remotemo {
@@ -89,6 +93,278 @@ enum class Do_reset { none, cursor, inverse, all };
 
 ////////////////////////////////////////////////////////////////////////
 
+/** \enum Clock_mode
+ * \brief Used to control what clock the monitor goes by
+ *
+ * \sa Config::clock()
+ *
+ * \var real
+ * Delays (e.g. \c Remotemo::pause() or the delay between characters) take
+ * real time.
+ *
+ * \var simulated
+ * Delays take no real time. They only advance a simulated clock, which is
+ * what everything that depends on time (e.g. recording a session) then goes
+ * by. The window still gets updated and events handled as usual.
+ */
+enum class Clock_mode { real, simulated };
+
+////////////////////////////////////////////////////////////////////////
+
+/** \enum Scaling_mode
+ * \brief Used to control how the background and the text get scaled to fit
+ * the window
+ *
+ * \sa Config::scaling()
+ *
+ * \var smooth
+ * Scaled by whatever factor makes the background's \c min_area fill the
+ * window, with linear filtering.
+ *
+ * \var integer
+ * Each texture gets scaled by a whole number (the largest one that still
+ * fits), without filtering (i.e. using nearest-neighbour sampling), and gets
+ * centered within whatever space is left over. Gives sharp, pixel-perfect
+ * output and is cheaper for software renderers.
+ */
+enum class Scaling_mode { smooth, integer };
+
+////////////////////////////////////////////////////////////////////////
+
+/** \enum Renderer_acceleration
+ * \brief Used to choose what kind of renderer to create
+ *
+ * \sa Config::renderer_acceleration()
+ *
+ * \var any
+ * Let SDL choose (usually an accelerated one, if there is any).
+ *
+ * \var accelerated
+ * Only a renderer that uses hardware acceleration.
+ *
+ * \var software
+ * Only the software renderer. Might well be the faster one, e.g. on a
+ * headless virtual machine where the "accelerated" ones are emulated.
+ */
+enum class Renderer_acceleration { any, accelerated, software };
+
+////////////////////////////////////////////////////////////////////////
+
+/** \enum Capture_format
+ * \brief Used to choose how the captured frames get written
+ *
+ * \sa Config::capture_frames()
+ *
+ * \var none
+ * No frames get captured.
+ *
+ * \var ppm
+ * Each frame gets written to its own (binary) PPM file.
+ *
+ * \var png
+ * Each frame gets written to its own PNG file.
+ *
+ * \var raw
+ * All the frames get written, one after the other, to a single file, as a
+ * raw video stream of 24-bit RGB pixels (e.g. for feeding to a video
+ * encoder, telling it the size of the window).
+ */
+enum class Capture_format { none, ppm, png, raw };
+
+////////////////////////////////////////////////////////////////////////
+
+/** \enum Replay_speed
+ * \brief Used to control how fast a recorded session gets replayed
+ *
+ * \sa Remotemo::replay()
+ * \sa Config::record_session_file()
+ *
+ * \var original
+ * Each operation is replayed at the same time (relative to the start) as
+ * it was done when recorded, and with the same delays.
+ *
+ * \var as_fast_as_possible
+ * The operations are replayed without any waiting, i.e. with no pauses and
+ * no delay between characters.
+ */
+enum class Replay_speed { original, as_fast_as_possible };
+
+////////////////////////////////////////////////////////////////////////
+
+/** \enum Startup_timing_mode
+ * \brief Used to control if the time spent starting up gets measured.
+ *
+ * \sa Config::startup_timing()
+ * \sa Remotemo::startup_timings()
+ *
+ * \var off
+ * Nothing gets measured.
+ *
+ * \var measure
+ * The timings get measured and can be fetched with \c
+ * Remotemo::startup_timings().
+ *
+ * \var measure_and_log
+ * Same as \c measure but the timings also get logged (with \c SDL_LogInfo())
+ * as soon as they are known.
+ */
+enum class Startup_timing_mode { off, measure, measure_and_log };
+
+////////////////////////////////////////////////////////////////////////
+
+/** \struct Startup_timings
+ * \brief Time spent (in milliseconds) in each phase of starting up.
+ *
+ * \note
+ * The font and background images get decoded on worker threads while the
+ * window and the renderer are being created. \c font_ms and \c
+ * background_ms therefore only contain the time spent waiting for that
+ * decoding to finish plus the time it took to create the textures.
+ *
+ * \sa Remotemo::startup_timings()
+ *
+ * \var Startup_timings::preparation_ms
+ * \brief Validating the config, opening the files for capturing frames
+ * and recording the session, parsing a console font and starting to decode
+ * the images.
+ *
+ * \var Startup_timings::sdl_init_ms
+ * \brief Initializing SDL (\c SDL_Init() and setting hints) only.
+ *
+ * \var Startup_timings::window_ms
+ * \brief Creating the window (zero if one was passed in with the config).
+ *
+ * \var Startup_timings::renderer_ms
+ * \brief Creating the renderer (zero if the window already had one).
+ *
+ * \var Startup_timings::font_ms
+ * \brief Creating the font texture.
+ *
+ * \var Startup_timings::background_ms
+ * \brief Creating the background texture.
+ *
+ * \var Startup_timings::text_area_ms
+ * \brief Creating the texture of the text area.
+ *
+ * \var Startup_timings::create_ms
+ * \brief Total time spent in \c remotemo::create().
+ *
+ * \var Startup_timings::first_render_ms
+ * \brief Time spent rendering (and presenting) the window the first time.
+ *
+ * Empty until the window has been rendered.
+ *
+ * \var Startup_timings::until_first_render_ms
+ * \brief Time from the start of \c remotemo::create() until the window had
+ * been rendered (and presented) the first time.
+ *
+ * Empty until the window has been rendered.
+ */
+struct Startup_timings {
+  double preparation_ms {};
+  double sdl_init_ms {};
+  double window_ms {};
+  double renderer_ms {};
+  double font_ms {};
+  double background_ms {};
+  double text_area_ms {};
+  double create_ms {};
+  std::optional<double> first_render_ms {};
+  std::optional<double> until_first_render_ms {};
+};
+
+////////////////////////////////////////////////////////////////////////
+
+/** \struct Render_stats
+ * \brief Counters and timings of the rendering, collected while running.
+ *
+ * \sa Remotemo::stats()
+ * \sa Remotemo::reset_stats()
+ *
+ * \var Render_stats::frames_presented
+ * \brief Number of times the window got rendered and presented.
+ *
+ * \var Render_stats::render_copy_calls
+ * \brief Number of textures (or parts of them, e.g. a single character)
+ * copied with \c SDL_RenderCopy() (or \c SDL_RenderCopyF()).
+ *
+ * \var Render_stats::render_target_switches
+ * \brief Number of times the render target got changed.
+ *
+ * \var Render_stats::full_refreshes
+ * \brief Number of presented frames for which the whole text area had to
+ * be redrawn (e.g. after scrolling or a change to the window).
+ *
+ * \var Render_stats::partial_refreshes
+ * \brief Number of presented frames for which only the changed part of the
+ * text area got redrawn.
+ *
+ * \var Render_stats::delay_ms
+ * \brief Time spent waiting, be it in \c Remotemo::pause() or in between
+ * characters being printed (includes any rendering done meanwhile).
+ *
+ * \var Render_stats::render_ms
+ * \brief Time spent rendering the window.
+ *
+ * \var Render_stats::frames_captured
+ * \brief Number of presented frames that got captured.
+ *
+ * \var Render_stats::frames_capture_dropped
+ * \brief Number of presented frames that did not get captured, because
+ * writing the earlier ones was lagging behind.
+ *
+ * \var Render_stats::steps_run
+ * \brief Number of steps run by \c Remotemo::run().
+ *
+ * \var Render_stats::steps_overrun
+ * \brief Number of steps (including the rendering that followed them) that
+ * took longer than the time of a step.
+ *
+ * \var Render_stats::steps_dropped
+ * \brief Number of steps that \c Remotemo::run() skipped, because it had
+ * fallen too far behind to catch up.
+ *
+ * \var Render_stats::line_cache_hits
+ * \brief Number of lines redrawn with a single copy from the line cache.
+ *
+ * \var Render_stats::line_cache_misses
+ * \brief Number of lines that were not in the line cache, so they got drawn
+ * character by character (and then added to the cache).
+ *
+ * \sa Config::line_cache_lines()
+ *
+ * \var Render_stats::frame_time_histogram
+ * \brief Number of frames, sorted by the time (in milliseconds) since the
+ * previous one was presented.
+ *
+ * The first bucket counts frames that took less than 1 ms. Then each bucket
+ * covers twice the time of the previous one (bucket \c i counting frames
+ * that took at least 2<sup>i-1</sup> ms but less than 2<sup>i</sup> ms),
+ * except the last one, which counts all that took 512 ms or more.
+ */
+struct Render_stats {
+  /// \brief Number of buckets in \c frame_time_histogram
+  static constexpr std::size_t frame_time_buckets {11};
+
+  Uint64 frames_presented {};
+  Uint64 render_copy_calls {};
+  Uint64 render_target_switches {};
+  Uint64 full_refreshes {};
+  Uint64 partial_refreshes {};
+  double delay_ms {};
+  double render_ms {};
+  Uint64 frames_captured {};
+  Uint64 frames_capture_dropped {};
+  Uint64 steps_run {};
+  Uint64 steps_overrun {};
+  Uint64 steps_dropped {};
+  Uint64 line_cache_hits {};
+  Uint64 line_cache_misses {};
+  std::array<Uint64, frame_time_buckets> frame_time_histogram {};
+};
+
+////////////////////////////////////////////////////////////////////////
+
 /** \brief Error codes for when move_cursor() tries to go past any border.
  *
  * When trying to go past more than one border, the values are added together
@@ -114,6 +390,37 @@ struct Size {
 
 ////////////////////////////////////////////////////////////////////////
 
+/** \struct Renderer_info
+ * \brief What renderer is actually being used.
+ *
+ * \sa Remotemo::renderer_info()
+ * \sa Config::renderer()
+ *
+ * \var Renderer_info::driver
+ * \brief The name of the render driver (e.g. \c "opengl" or \c "software").
+ *
+ * \var Renderer_info::is_accelerated
+ * \brief Whether the renderer uses hardware acceleration.
+ *
+ * \var Renderer_info::is_vsync
+ * \brief Whether presenting is synchronized with the refresh rate.
+ *
+ * \var Renderer_info::has_target_texture
+ * \brief Whether the renderer supports rendering to a texture.
+ *
+ * \var Renderer_info::max_texture_size
+ * \brief The maximum size of a texture (0 meaning no limit, or unknown).
+ */
+struct Renderer_info {
+  std::string driver {};
+  bool is_accelerated {false};
+  bool is_vsync {false};
+  bool has_target_texture {false};
+  Size max_texture_size {0, 0};
+};
+
+////////////////////////////////////////////////////////////////////////
+
 /** \struct Point
  * \brief Used to store a position.
  *
@@ -432,5 +739,40 @@ private:
   SDL_Scancode m_key;
 };
 
+////////////////////////////////////////////////////////////////////////
+
+/** \struct Run_step
+ * \brief What the function given to \c Remotemo::run() gets for each step.
+ *
+ * \sa Remotemo::run()
+ *
+ * \var Run_step::number
+ * \brief Number of the step, starting at 0 (skipping any dropped ones).
+ *
+ * \var Run_step::step_ms
+ * \brief The (fixed) time of each step, in milliseconds.
+ *
+ * \var Run_step::elapsed_ms
+ * \brief Time since \c Remotemo::run() started, as of this step (i.e.
+ * always a multiple of \c step_ms).
+ *
+ * \var Run_step::lag_ms
+ * \brief How late the step is being run, compared to when it was due.
+ *
+ * Anything more than a single step means that the steps are being run one
+ * after the other, without rendering in between, to catch up.
+ *
+ * \var Run_step::keys
+ * \brief The keys pressed since the previous step, in the order they were
+ * pressed.
+ */
+struct Run_step {
+  Uint64 number {0};
+  double step_ms {0.0};
+  double elapsed_ms {0.0};
+  double lag_ms {0.0};
+  std::vector<Key> keys {};
+};
+
 } // namespace remotemo
 #endif // REMOTEMO_COMMON_TYPES_HPP
@@ -91,6 +91,52 @@ struct Window_config {
 
 ////////////////////////////////////////////////////////////////////////
 
+/** \struct Renderer_config
+ * \brief Used for the config of the renderer
+ *
+ * Only used when creating a new renderer, i.e. ignored if a window (that
+ * already has its renderer) gets passed in.
+ *
+ * \sa Config::renderer()
+ * \sa Config::renderer_driver()
+ * \sa Config::renderer_acceleration()
+ * \sa Config::renderer_vsync()
+ * \sa Config::renderer_requires_target_texture()
+ * \sa Remotemo::renderer_info()
+ *
+ * \var Renderer_config::driver
+ * \brief Name of the preferred render driver (e.g. \c "opengl",
+ * \c "opengles2" or \c "software").
+ *
+ * Given to SDL as a hint, meaning that if there is no such driver (or it
+ * does not work), SDL falls back to another one. Leave it empty to let SDL
+ * choose.
+ *
+ * \var Renderer_config::acceleration
+ * \brief What kind of renderer to create.
+ *
+ * \sa Renderer_acceleration
+ *
+ * \var Renderer_config::is_vsync
+ * \brief Whether presenting should be synchronized with the refresh rate.
+ *
+ * \var Renderer_config::is_target_texture_required
+ * \brief Whether SDL should only consider render drivers that support
+ * rendering to a texture.
+ *
+ * If \c false, SDL chooses by its own order of preference only. Either way,
+ * this library needs that support, so creating the monitor fails if the
+ * renderer turns out not to have it.
+ */
+struct Renderer_config {
+  std::string driver;
+  Renderer_acceleration acceleration;
+  bool is_vsync;
+  bool is_target_texture_required;
+};
+
+////////////////////////////////////////////////////////////////////////
+
 /** \struct Texture_config
  * \brief Base struct for configuration of textures
  *
@@ -147,6 +193,17 @@ struct Window_config {
  *
  * - Otherwise the path is relative to your executable program file.
  *
+ * \note
+ * Unless the library was built with the CMake option \c
+ * REMOTEMO_EMBED_RESOURCES set to \c OFF, the default files (\c
+ * "res/img/terminal_screen.png" and \c "res/img/font_bitmap.png") are
+ * compiled into the library itself. Those paths are then loaded from memory,
+ * without any file access, and the \c res folder does not need to be copied
+ * next to your executable program file. Only if the library was also built
+ * with the CMake option \c REMOTEMO_FILES_OVERRIDE_EMBEDDED set to \c ON, a
+ * file at one of those paths (e.g. to replace the default) gets loaded
+ * instead of the copy in memory.
+ *
  * \sa Config::background_file_path()
  * \sa Config::font_bitmap_file_path()
  */
@@ -202,6 +259,7 @@ struct Backgr_config : Texture_config {
  * \sa Config::font_bitmap()
  * \sa Config::font_bitmap_file_path()
  * \sa Config::font_size()
+ * \sa Config::font_psf_file()
  *
  * \var Font_config::width
  * \brief Width in pixels of each character as they are drawn in the
@@ -210,10 +268,15 @@ struct Backgr_config : Texture_config {
  * \var Font_config::height
  * \brief Height in pixels of each character as they are drawn in the
  * font-bitmap file.
+ *
+ * \var Font_config::psf_file_path
+ * \brief Path to a console font (PSF or BDF) to use instead of the
+ * font-bitmap file, or empty if none.
  */
 struct Font_config : Texture_config {
   int width;
   int height;
+  std::string psf_file_path;
 };
 
 ////////////////////////////////////////////////////////////////////////
@@ -246,12 +309,42 @@ struct Font_config : Texture_config {
  * See the documentation of the \c SDL2 library for \c SDL_SetTextureColorMod
  * on how the color affects the rendering of the text on top of the
  * background texture.
+ *
+ * \var Text_area_config::scrollback_lines
+ * \brief Maximum number of lines, scrolled off the top of the text area, to
+ * keep so that the view can be scrolled back to them.
+ *
+ * Uses two bytes per character, allocated up front.
+ *
+ * \var Text_area_config::canvas_columns
+ * \brief Width of the whole text area (the canvas), in characters, if wider
+ * than what is shown (i.e. \c columns).
+ *
+ * \var Text_area_config::canvas_lines
+ * \brief Height of the whole text area (the canvas), in characters, if
+ * higher than what is shown (i.e. \c lines).
+ *
+ * \var Text_area_config::line_cache_lines
+ * \brief Maximum number of rendered lines to keep, so that a line that has
+ * been shown before can be redrawn in one go (0 turns the cache off).
+ *
+ * Uses a texture as wide as the view and this many lines high, created the
+ * first time it is needed.
+ *
+ * \var Text_area_config::is_double_buffered
+ * \brief Whether the text gets drawn into one texture while another one is
+ * being shown.
  */
 struct Text_area_config {
   int columns;
   int lines;
   SDL_BlendMode blend_mode;
   Color color;
+  int scrollback_lines {0};
+  int canvas_columns {0};
+  int canvas_lines {0};
+  int line_cache_lines {0};
+  bool is_double_buffered {false};
 };
 
 ////////////////////////////////////////////////////////////////////////
@@ -335,6 +428,190 @@ public:
    */
   [[nodiscard]] bool cleanup_all() const { return m_cleanup_all; }
 
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Sets if the time spent starting up should be measured
+   *
+   * - (\b default) If set to \c Startup_timing_mode::off, nothing gets
+   *   measured.
+   * - If set to \c Startup_timing_mode::measure, the time spent in each phase
+   *   of \c remotemo::create() and in rendering the window for the first
+   *   time gets measured.
+   * - If set to \c Startup_timing_mode::measure_and_log, those timings also
+   *   get logged.
+   *
+   * \param mode New setting of the property
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Remotemo::startup_timings()
+   */
+  Config& startup_timing(Startup_timing_mode mode);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Get the setting of the \c startup_timing property
+   *
+   * \return The \c startup_timing property
+   *
+   * \sa Config::startup_timing(Startup_timing_mode)
+   */
+  [[nodiscard]] Startup_timing_mode startup_timing() const
+  {
+    return m_startup_timing;
+  }
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Sets what clock the monitor goes by
+   *
+   * - (\b default) If set to \c Clock_mode::real, pauses and the delay
+   *   between characters take real time.
+   * - If set to \c Clock_mode::simulated, they only advance a simulated
+   *   clock and return at once. Useful for tests and for scripted batch
+   *   runs, where nobody is watching.
+   *
+   * \param mode New setting of the property
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Clock_mode
+   */
+  Config& clock(Clock_mode mode);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Get the setting of the \c clock property
+   *
+   * \return The \c clock property
+   *
+   * \sa Config::clock(Clock_mode)
+   */
+  [[nodiscard]] Clock_mode clock() const { return m_clock_mode; }
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Sets how the background and the text get scaled to fit the
+   * window
+   *
+   * - (\b default) If set to \c Scaling_mode::smooth, they get scaled by any
+   *   factor, with linear filtering.
+   * - If set to \c Scaling_mode::integer, each of them gets scaled by a
+   *   whole number, with nearest-neighbour sampling, and centered within
+   *   the space left over.
+   *
+   * \param mode New setting of the property
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Scaling_mode
+   */
+  Config& scaling(Scaling_mode mode);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Get the setting of the \c scaling property
+   *
+   * \return The \c scaling property
+   *
+   * \sa Config::scaling(Scaling_mode)
+   */
+  [[nodiscard]] Scaling_mode scaling() const { return m_scaling_mode; }
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Sets if (and how) the presented frames should be captured
+   *
+   * Every frame that gets presented (i.e. every time anything on the
+   * monitor changes) is read back and written to a file, by a separate
+   * thread so that it does not slow down the monitor. If writing falls
+   * behind, frames get dropped (see \c Render_stats::frames_capture_dropped)
+   * rather than waited for.
+   *
+   * The frames get rendered even if the window is hidden, so this can be
+   * used without any visible window (e.g. with the \c dummy video driver).
+   *
+   * With \c Capture_format::ppm and \c Capture_format::png the files are
+   * named \p path_prefix followed by the number of the frame (6 digits,
+   * starting at 0) and the extension. With \c Capture_format::raw there is
+   * only one file, named \p path_prefix followed by \c ".rgb".
+   *
+   * \param path_prefix The start of the path of the written files
+   * \param format      The format to write the frames in (\b default:
+   *                    \c Capture_format::none, i.e. nothing gets captured)
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Capture_format
+   */
+  Config& capture_frames(const std::string& path_prefix,
+      Capture_format format = Capture_format::ppm);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Get the format of the captured frames
+   *
+   * \return The format, or \c Capture_format::none if no frames are
+   *         captured
+   *
+   * \sa Config::capture_frames(const std::string&, Capture_format)
+   */
+  [[nodiscard]] Capture_format capture_format() const
+  {
+    return m_capture_format;
+  }
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Get the start of the path of the captured frames
+   *
+   * \return The prefix of the path
+   *
+   * \sa Config::capture_frames(const std::string&, Capture_format)
+   */
+  [[nodiscard]] const std::string& capture_path_prefix() const
+  {
+    return m_capture_path_prefix;
+  }
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Sets the file to record the session to
+   *
+   * If set, every printing, cursor move, change of the \c inverse, \c
+   * escape_sequences, \c scrolling or \c wrapping setting or of the delay
+   * between characters, move of the view (or of the scrollback view),
+   * clearing of the screen, pause and key returned by \c
+   * Remotemo::get_key() gets written to the file (in a compact binary
+   * format), along with the time it happened at.
+   *
+   * The recorded session can then be replayed with \c Remotemo::replay().
+   *
+   * If the file cannot be opened for writing, then \c remotemo::create()
+   * fails.
+   *
+   * \param file_path New setting of the property (\b default: empty, which
+   *                  means that nothing gets recorded)
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Remotemo::replay()
+   */
+  Config& record_session_file(const std::string& file_path);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Get the setting of the \c record_session_file property
+   *
+   * \return The \c record_session_file property
+   *
+   * \sa Config::record_session_file(const std::string&)
+   */
+  [[nodiscard]] const std::string& record_session_file() const
+  {
+    return m_record_session_file;
+  }
+
 
   //////////////////////////////////////////////////////////////////////
 
@@ -469,6 +746,89 @@ public:
    */
   [[nodiscard]] const Window_config& window() const { return m_window; }
 
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Sets the config for the creation of the renderer
+   *
+   * \param renderer New setting of the property
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Renderer_config
+   */
+  Config& renderer(const Renderer_config& renderer);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Sets the name of the preferred render driver
+   *
+   * \b Default: \c "" (i.e. let SDL choose)
+   *
+   * \param driver New setting of the property
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Renderer_config::driver
+   */
+  Config& renderer_driver(const std::string& driver);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Sets what kind of renderer to create
+   *
+   * \b Default: \c Renderer_acceleration::any
+   *
+   * \param acceleration New setting of the property
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Renderer_config::acceleration
+   */
+  Config& renderer_acceleration(Renderer_acceleration acceleration);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Sets whether presenting should be synchronized with the refresh
+   * rate
+   *
+   * \b Default: \c false
+   *
+   * \param is_vsync New setting of the property
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Renderer_config::is_vsync
+   */
+  Config& renderer_vsync(bool is_vsync);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Sets whether only render drivers that support rendering to a
+   * texture should be considered
+   *
+   * \b Default: \c true
+   *
+   * \param is_required New setting of the property
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Renderer_config::is_target_texture_required
+   */
+  Config& renderer_requires_target_texture(bool is_required);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Get the current config for the creation of the renderer
+   *
+   * \return Constant reference to the config for the renderer
+   *
+   * \sa Renderer_config
+   */
+  [[nodiscard]] const Renderer_config& renderer() const
+  {
+    return m_renderer;
+  }
+
 
   //////////////////////////////////////////////////////////////////////
 
@@ -655,6 +1015,163 @@ public:
    */
   Config& key_quit(Mod_keys_strict modifier_keys, Key key);
 
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Sets the keyboard shortcut to scroll the view back a page
+   *
+   * With no parameters the keyboard shortcut is set to none.
+   *
+   * \b Default: \c Ctrl-Shift-Up
+   *
+   * Only has an effect if lines get kept in the scrollback. If not, the
+   * key gets returned by \c Remotemo::get_key() like any other.
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Config::scrollback_lines()
+   * \sa Remotemo::set_scrollback_view()
+   */
+  Config& key_scroll_back();
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \overload
+   *
+   * Accepts an F-key and any combination of modifier keys (including no
+   * modifier keys).
+   *
+   * \param modifier_keys New setting of the property
+   * \param key New setting of the property
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Mod_keys
+   * \sa F_key
+   */
+  Config& key_scroll_back(Mod_keys modifier_keys, F_key key);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \overload
+   *
+   * Accepts any "normal" key and a strict subset of the modifier key
+   * combinations.
+   *
+   * \param modifier_keys New setting of the property
+   * \param key New setting of the property
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Mod_keys_strict
+   * \sa Key
+   */
+  Config& key_scroll_back(Mod_keys_strict modifier_keys, Key key);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Sets the keyboard shortcut to scroll the view forward a page
+   *
+   * With no parameters the keyboard shortcut is set to none.
+   *
+   * \b Default: \c Ctrl-Shift-Down
+   *
+   * Only has an effect if lines get kept in the scrollback. If not, the
+   * key gets returned by \c Remotemo::get_key() like any other.
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Config::key_scroll_back()
+   */
+  Config& key_scroll_forward();
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \overload
+   *
+   * Accepts an F-key and any combination of modifier keys (including no
+   * modifier keys).
+   *
+   * \param modifier_keys New setting of the property
+   * \param key New setting of the property
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Mod_keys
+   * \sa F_key
+   */
+  Config& key_scroll_forward(Mod_keys modifier_keys, F_key key);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \overload
+   *
+   * Accepts any "normal" key and a strict subset of the modifier key
+   * combinations.
+   *
+   * \param modifier_keys New setting of the property
+   * \param key New setting of the property
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Mod_keys_strict
+   * \sa Key
+   */
+  Config& key_scroll_forward(Mod_keys_strict modifier_keys, Key key);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Sets the keyboard shortcut to skip the animation of the text
+   * being printed
+   *
+   * Pressing it while \c Remotemo::print() is printing makes the rest of
+   * the text go out at once (i.e. without the delay between characters).
+   * The next call prints at the normal speed again.
+   *
+   * With no parameters the keyboard shortcut is set to none.
+   *
+   * \b Default: none
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Handle::skip_animation()
+   * \sa Remotemo::set_text_delay()
+   */
+  Config& key_skip_animation();
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \overload
+   *
+   * Accepts an F-key and any combination of modifier keys (including no
+   * modifier keys).
+   *
+   * \param modifier_keys New setting of the property
+   * \param key New setting of the property
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Mod_keys
+   * \sa F_key
+   */
+  Config& key_skip_animation(Mod_keys modifier_keys, F_key key);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \overload
+   *
+   * Accepts any "normal" key and a strict subset of the modifier key
+   * combinations.
+   *
+   * \param modifier_keys New setting of the property
+   * \param key New setting of the property
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Mod_keys_strict
+   * \sa Key
+   */
+  Config& key_skip_animation(Mod_keys_strict modifier_keys, Key key);
+
 
   //////////////////////////////////////////////////////////////////////
 
@@ -903,6 +1420,18 @@ public:
   //////////////////////////////////////////////////////////////////////
 
   /** \brief Sets the path to use if loading the font-bitmap texture.
+   *
+   * The bitmap is made of pages, one below the other. Each page has 128
+   * characters, in 8 rows of 16, followed by the same characters with the
+   * colors inversed (so 16 rows in all). The first page holds ASCII, and the
+   * next ones, if there, hold U+0080 to U+00FF (Latin-1), U+2500 to U+257F
+   * (box drawing) and U+2580 to U+25FF (block elements and geometric
+   * shapes). The default font only has the first page.
+   *
+   * A bitmap of only the 8 rows of ASCII characters is fine as well. The
+   * inversed characters then get made from those, when the bitmap gets
+   * loaded. (Or, for a texture set with \c font_bitmap(), the first time
+   * anything gets printed.)
    *
    * \b Default: \c "res/img/font_bitmap.png"
    *
@@ -948,6 +1477,35 @@ public:
 
   //////////////////////////////////////////////////////////////////////
 
+  /** \brief Sets the path to a console font to use instead of the
+   * font-bitmap
+   *
+   * The font can be a Linux console font (PSF, version 1 or 2, e.g. from \c
+   * /usr/share/consolefonts, but not compressed) or a BDF font. The
+   * font-bitmap gets built from it, and the size of the characters is taken
+   * from it (so \c font_size() does not matter).
+   *
+   * Only the characters that the pages of a font-bitmap can hold (see \c
+   * font_bitmap_file_path()) are used. A PSF font without a Unicode table,
+   * and the encoding of the characters of a BDF font, are taken to be
+   * Latin-1 (or Unicode) code points. Characters of up to 64x64 pixels are
+   * supported. The cursor is shown as the full block (U+2588) of the font,
+   * or as a filled square if it has none.
+   *
+   * Ignored if a font-bitmap texture has been set with \c font_bitmap().
+   *
+   * \b Default: \c "" (i.e. none)
+   *
+   * \param file_path New setting of the property
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Font_config::psf_file_path
+   */
+  Config& font_psf_file(const std::string& file_path);
+
+  //////////////////////////////////////////////////////////////////////
+
   /** \brief Get the config for the creation of the font-bitmap texture
    *
    * \return Constant reference to the config for the font-bitmap texture
@@ -995,6 +1553,45 @@ public:
 
   //////////////////////////////////////////////////////////////////////
 
+  /** \brief Sets the size of the whole text area, if larger than shown
+   *
+   * By default the text area is exactly as big as what is shown on the
+   * screen (see \c text_area_size()). With a larger size, the text area
+   * becomes a canvas that the screen only shows a part of, that can be moved
+   * around with \c Remotemo::set_view_position(). Everything else (printing,
+   * the cursor, scrolling, etc.) works on the whole canvas.
+   *
+   * Only the part that is shown gets drawn, so the size of the canvas does
+   * not affect the size of any texture.
+   *
+   * A size smaller than what is shown (e.g. the default of 0) is taken to be
+   * the same as what is shown.
+   *
+   * \param columns New setting of the property
+   * \param lines New setting of the property
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Text_area_config::canvas_columns
+   * \sa Text_area_config::canvas_lines
+   * \sa Remotemo::set_view_position()
+   */
+  Config& text_canvas_size(int columns, int lines);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \overload
+   *
+   * \param size New setting of the property
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Size
+   */
+  Config& text_canvas_size(const Size& size);
+
+  //////////////////////////////////////////////////////////////////////
+
   /** \brief Sets the blend mode used to render the text onto the background
    *
    * \param mode New setting of the property
@@ -1034,6 +1631,73 @@ public:
 
   //////////////////////////////////////////////////////////////////////
 
+  /** \brief Sets how many lines scrolled off the text area should be kept
+   *
+   * Those lines can then be viewed again by scrolling the view back, either
+   * with \c Remotemo::set_scrollback_view() or with the keyboard shortcuts
+   * set with \c Config::key_scroll_back() and \c
+   * Config::key_scroll_forward().
+   *
+   * Once the scrollback is full, the oldest line gets dropped for each new
+   * one, so the memory used stays the same (two bytes per character, i.e.
+   * twice \p lines times the number of columns).
+   *
+   * \param lines New setting of the property (\b default: 0, i.e. nothing
+   *              is kept)
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Text_area_config::scrollback_lines
+   */
+  Config& scrollback_lines(int lines);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Sets how many rendered lines to keep, for redrawing them faster
+   *
+   * The text area gets redrawn from scratch after each scroll and whenever
+   * the view gets scrolled back (e.g. when paging through the scrollback).
+   * Without the cache, each character gets drawn on its own, while a line
+   * found in the cache gets drawn with a single copy.
+   *
+   * When the cache is full, the line that was least recently shown gets
+   * dropped. A line is kept as a strip of the text texture, so the memory
+   * used is that of a texture as wide as the view and \p lines high (capped
+   * at 8192 pixels).
+   *
+   * \param lines New setting of the property (\b default: 0, i.e. no
+   *              cache)
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Text_area_config::line_cache_lines
+   */
+  Config& line_cache_lines(int lines);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Sets whether the text area should be double buffered
+   *
+   * Without double buffering, the text gets drawn into the same texture as
+   * the one being shown, which on some drivers makes the drawing wait for
+   * the previous frame to finish.
+   *
+   * When double buffered, the text gets drawn into one texture while the
+   * other one is shown, and they then swap places. Only the parts changed
+   * since get copied from one to the other. That takes a second texture of
+   * the same size as the text area, created the first time it is needed.
+   *
+   * \param is_double_buffered New setting of the property (\b default:
+   *                           \c false)
+   *
+   * \return The object itself (to allow chaining of setters).
+   *
+   * \sa Text_area_config::is_double_buffered
+   */
+  Config& text_double_buffered(bool is_double_buffered);
+
+  //////////////////////////////////////////////////////////////////////
+
   /** \brief Get the current config for the setup of the text area
    *
    * \return Constant reference to the config for the text area
@@ -1051,16 +1715,28 @@ private:
   bool validate(SDL_Renderer* renderer) const;
 
   bool m_cleanup_all {true};
+  Startup_timing_mode m_startup_timing {Startup_timing_mode::off};
+  Clock_mode m_clock_mode {Clock_mode::real};
+  Scaling_mode m_scaling_mode {Scaling_mode::smooth};
+  std::string m_record_session_file {};
+  Capture_format m_capture_format {Capture_format::none};
+  std::string m_capture_path_prefix {};
   Window_config m_window {nullptr, "Retro Monochrome Text Monitor"s,
       // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
       1280, 720, SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, true,
       false};
+  Renderer_config m_renderer {""s, Renderer_acceleration::any, false, true};
   std::optional<Key_combo> m_key_fullscreen {
       std::in_place, Mod_keys::None, F_key::F11};
   std::optional<Key_combo> m_key_close_window {
       std::in_place, Mod_keys_strict::Ctrl, Key::K_w};
   std::optional<Key_combo> m_key_quit {
       std::in_place, Mod_keys_strict::Ctrl, Key::K_q};
+  std::optional<Key_combo> m_key_scroll_back {
+      std::in_place, Mod_keys_strict::Ctrl_shift, Key::K_up};
+  std::optional<Key_combo> m_key_scroll_forward {
+      std::in_place, Mod_keys_strict::Ctrl_shift, Key::K_down};
+  std::optional<Key_combo> m_key_skip_animation {};
   bool m_is_closing_same_as_quit {false};
   std::function<bool()> m_pre_close_function {[]() -> bool { return true; }};
   std::function<bool()> m_pre_quit_function {[]() -> bool { return true; }};
@@ -1070,7 +1746,7 @@ private:
       // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
       Rect<float> {188.25f, 149.25f, 560.0f, 432.0f}};
   // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
-  Font_config m_font {{nullptr, "res/img/font_bitmap.png"s}, 7, 18};
+  Font_config m_font {{nullptr, "res/img/font_bitmap.png"s}, 7, 18, ""s};
   Text_area_config m_text_area {
       // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
       40, 24, SDL_BLENDMODE_ADD, Color {89, 221, 0}};
@@ -0,0 +1,423 @@
+/**
+ * \file
+ * \brief Header file for the (optional) coroutine API of \c remoTemo.
+ *
+ * Unlike the rest of the library, this requires C++20. It is header-only, so
+ * the library itself does not have to be built as C++20.
+ */
+
+#ifndef REMOTEMO_COROUTINES_HPP
+#define REMOTEMO_COROUTINES_HPP
+
+#if !defined(__cpp_impl_coroutine) || __cpp_impl_coroutine < 201902L
+#error "remotemo/coroutines.hpp needs C++20 (with coroutines)"
+#endif
+
+#include <algorithm>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "remotemo/remotemo.hpp"
+
+/// \brief Coroutines for running several text sequences at the same time
+namespace remotemo::co {
+template<class T> class Task;
+
+namespace detail {
+template<class T> struct Task_promise;
+
+// Resumes whoever was waiting for the task to finish (if anyone).
+template<class Promise> struct Final_awaiter {
+  [[nodiscard]] bool await_ready() const noexcept { return false; }
+  std::coroutine_handle<> await_suspend(
+      std::coroutine_handle<Promise> handle) noexcept
+  {
+    auto continuation = handle.promise().continuation;
+    if (continuation) {
+      return continuation;
+    }
+    return std::noop_coroutine();
+  }
+  void await_resume() const noexcept {}
+};
+
+struct Task_promise_base {
+  std::suspend_always initial_suspend() noexcept { return {}; }
+  void unhandled_exception() noexcept
+  {
+    exception = std::current_exception();
+  }
+
+  std::coroutine_handle<> continuation {};
+  std::exception_ptr exception {};
+};
+
+template<class T> struct Task_promise : Task_promise_base {
+  Task<T> get_return_object() noexcept;
+  Final_awaiter<Task_promise> final_suspend() noexcept { return {}; }
+  void return_value(T value) { result.emplace(std::move(value)); }
+
+  std::optional<T> result {};
+};
+
+template<> struct Task_promise<void> : Task_promise_base {
+  Task<void> get_return_object() noexcept;
+  Final_awaiter<Task_promise> final_suspend() noexcept { return {}; }
+  void return_void() noexcept {}
+};
+
+// Runs a spawned task. Any exception from the task (e.g.
+// remotemo::Window_is_closed_exception) gets thrown out of whoever resumed
+// it, i.e. Remotemo::run_scheduled(). The frame (along with the frames of
+// the tasks it waits for) is kept until the Monitor that spawned it destroys
+// it, whether it has finished or not.
+struct Spawned {
+  struct promise_type {
+    Spawned get_return_object() noexcept
+    {
+      return {std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() { throw; }
+  };
+
+  std::coroutine_handle<promise_type> handle;
+};
+} // namespace detail
+
+////////////////////////////////////////////////////////////////////////
+
+/** \brief A coroutine that can be waited for (using \c co_await) or
+ * spawned, to run along with others
+ *
+ * A task does not start running until it is either waited for or spawned.
+ *
+ * \tparam T The type of what the task returns (with \c co_return).
+ *
+ * \sa Monitor::spawn()
+ */
+template<class T = void> class Task {
+public:
+  /// \brief Not part of public API. Needed by the compiler.
+  using promise_type = detail::Task_promise<T>;
+
+  /// \brief Not part of public API. Used by \c promise_type.
+  explicit Task(std::coroutine_handle<promise_type> handle) noexcept
+      : m_handle(handle)
+  {}
+  /// \brief Destructor
+  ~Task()
+  {
+    if (m_handle) {
+      m_handle.destroy();
+    }
+  }
+  /// \brief Move-constructor
+  Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, {}))
+  {}
+  /// \brief Move assignment operator
+  Task& operator=(Task&& other) noexcept
+  {
+    std::swap(m_handle, other.m_handle);
+    return *this;
+  }
+  /// \brief Copy-constructor (DELETED)
+  Task(const Task&) = delete;
+  /// \brief Copy assignment operator (DELETED)
+  Task& operator=(const Task&) = delete;
+
+  /// \brief Not part of public API. Makes the task awaitable.
+  auto operator co_await() && noexcept
+  {
+    struct Awaiter {
+      std::coroutine_handle<promise_type> handle;
+
+      [[nodiscard]] bool await_ready() const noexcept { return false; }
+      std::coroutine_handle<> await_suspend(
+          std::coroutine_handle<> awaiting) noexcept
+      {
+        handle.promise().continuation = awaiting;
+        return handle;
+      }
+      T await_resume()
+      {
+        auto& promise = handle.promise();
+        if (promise.exception) {
+          std::rethrow_exception(promise.exception);
+        }
+        if constexpr (!std::is_void_v<T>) {
+          return std::move(*promise.result);
+        }
+      }
+    };
+    return Awaiter {m_handle};
+  }
+
+private:
+  std::coroutine_handle<promise_type> m_handle;
+};
+
+namespace detail {
+template<class T> Task<T> Task_promise<T>::get_return_object() noexcept
+{
+  return Task<T> {
+      std::coroutine_handle<Task_promise<T>>::from_promise(*this)};
+}
+
+inline Task<void> Task_promise<void>::get_return_object() noexcept
+{
+  return Task<void> {
+      std::coroutine_handle<Task_promise<void>>::from_promise(*this)};
+}
+
+inline Spawned run_spawned(Task<void> task)
+{
+  co_await std::move(task);
+}
+} // namespace detail
+
+////////////////////////////////////////////////////////////////////////
+
+/** \brief Wraps a \c remotemo::Remotemo object, providing output and input
+ * that suspend the coroutine rather than blocking
+ *
+ * Example:
+ * \code{.cpp}
+ *   remotemo::co::Task<> ticker(remotemo::co::Monitor& mon)
+ *   {
+ *     for (int i = 0; i < 10; i++) {
+ *       co_await mon.print_at({0, 0}, std::to_string(i));
+ *       co_await mon.pause(1000);
+ *     }
+ *   }
+ *   ...
+ *   remotemo::co::Monitor mon {*text_monitor};
+ *   mon.spawn(ticker(mon));
+ *   mon.spawn(prompt(mon));
+ *   mon.run();
+ * \endcode
+ *
+ * Everything runs on the thread that owns the \c remotemo::Remotemo object,
+ * one coroutine at a time, switching whenever one of them waits.
+ *
+ * \note Calling the blocking functions of \c remotemo::Remotemo (e.g. \c
+ * pause(), \c get_key(), or \c print() with a delay between characters)
+ * from a coroutine makes all the others wait as well.
+ */
+class Monitor {
+public:
+  /// \brief Awaitable returned by \c pause().
+  class Pause_awaiter {
+  public:
+    Pause_awaiter(Remotemo* monitor, int pause_in_ms) noexcept
+        : m_monitor(monitor), m_pause_in_ms(pause_in_ms)
+    {}
+    [[nodiscard]] bool await_ready() const noexcept
+    {
+      return m_pause_in_ms < 0;
+    }
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+      m_monitor->schedule(m_pause_in_ms, [handle]() { handle.resume(); });
+    }
+    [[nodiscard]] int await_resume() const noexcept
+    {
+      return m_pause_in_ms < 0 ? -1 : 0;
+    }
+
+  private:
+    Remotemo* m_monitor;
+    int m_pause_in_ms;
+  };
+
+  /// \brief Awaitable returned by \c key().
+  class Key_awaiter {
+  public:
+    explicit Key_awaiter(Remotemo* monitor) noexcept : m_monitor(monitor) {}
+    [[nodiscard]] bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+      m_monitor->schedule_on_key([this, handle](Key key) {
+        m_key = key;
+        handle.resume();
+      });
+    }
+    [[nodiscard]] Key await_resume() const noexcept { return m_key; }
+
+  private:
+    Remotemo* m_monitor;
+    Key m_key {};
+  };
+
+  /** \brief Constructor
+   *
+   * \param monitor The monitor to use. Must outlive this object, along
+   * with all the coroutines using it.
+   */
+  explicit Monitor(Remotemo& monitor) noexcept : m_monitor(&monitor) {}
+
+  /** \brief Destructor
+   *
+   * Destroys the spawned tasks that have not finished (e.g. because \c
+   * run() threw an exception). If there are any, then everything scheduled
+   * on the wrapped monitor gets dropped as well (see \c
+   * Remotemo::cancel_scheduled()), since that is what they were waiting
+   * for.
+   */
+  ~Monitor()
+  {
+    const bool is_any_waiting = std::any_of(m_spawned.begin(),
+        m_spawned.end(), [](auto handle) { return !handle.done(); });
+    if (is_any_waiting) {
+      m_monitor->cancel_scheduled();
+    }
+    for (auto handle : m_spawned) {
+      handle.destroy();
+    }
+  }
+  /// \brief Move-constructor (DELETED)
+  Monitor(Monitor&&) = delete;
+  /// \brief Move assignment operator (DELETED)
+  Monitor& operator=(Monitor&&) = delete;
+  /// \brief Copy-constructor (DELETED)
+  Monitor(const Monitor&) = delete;
+  /// \brief Copy assignment operator (DELETED)
+  Monitor& operator=(const Monitor&) = delete;
+
+  /** \brief Get the wrapped monitor
+   *
+   * \return The monitor, e.g. for using its functions that do not wait.
+   */
+  [[nodiscard]] Remotemo& monitor() const noexcept { return *m_monitor; }
+
+  /** \brief Waits (without blocking the other coroutines)
+   *
+   * \param pause_in_ms The time to wait (in milliseconds).
+   *
+   * \return An awaitable, which gives the same values as \c
+   * Remotemo::pause().
+   */
+  [[nodiscard]] Pause_awaiter pause(int pause_in_ms) const noexcept
+  {
+    return Pause_awaiter {m_monitor, pause_in_ms};
+  }
+
+  /** \brief Waits for a key being pressed (without blocking the other
+   * coroutines)
+   *
+   * \return An awaitable, which gives the key.
+   */
+  [[nodiscard]] Key_awaiter key() const noexcept
+  {
+    return Key_awaiter {m_monitor};
+  }
+
+  /** \brief Prints at the cursor (without blocking the other coroutines)
+   *
+   * The same as \c Remotemo::print(), except that the delay between
+   * characters is waited the same way as \c pause() does.
+   *
+   * \param text The text to print.
+   *
+   * \return A task, which gives the same values as \c Remotemo::print().
+   */
+  [[nodiscard]] Task<int> print(std::string text) const
+  {
+    return print_text(std::nullopt, std::move(text));
+  }
+
+  /** \brief Prints at a position (without blocking the other coroutines)
+   *
+   * The text keeps its own cursor, starting at \p pos, so other coroutines
+   * moving the cursor in between its characters do not affect it.
+   *
+   * \param pos Where to start printing.
+   * \param text The text to print.
+   *
+   * \return A task, which gives the same values as \c
+   * Remotemo::print_at().
+   */
+  [[nodiscard]] Task<int> print_at(const Point& pos, std::string text) const
+  {
+    return print_text(pos, std::move(text));
+  }
+
+  /** \brief Starts running a task, along with the others
+   *
+   * It runs up to the first time it waits right away, and the rest of it
+   * within \c run().
+   *
+   * \param task The task to run.
+   */
+  void spawn(Task<> task)
+  {
+    destroy_finished();
+    auto handle = detail::run_spawned(std::move(task)).handle;
+    // Owned before it starts, in case it throws:
+    m_spawned.push_back(handle);
+    handle.resume();
+  }
+
+  /** \brief Runs all the spawned tasks until they have all finished
+   *
+   * \return The same values as \c Remotemo::run_scheduled().
+   */
+  int run()
+  {
+    auto result = m_monitor->run_scheduled();
+    destroy_finished();
+    return result;
+  }
+
+private:
+  void destroy_finished()
+  {
+    std::erase_if(m_spawned, [](auto handle) {
+      if (!handle.done()) {
+        return false;
+      }
+      handle.destroy();
+      return true;
+    });
+  }
+
+  Task<int> print_text(std::optional<Point> pos, std::string text) const
+  {
+    for (const auto character : text) {
+      auto delay_in_ms = m_monitor->get_text_delay();
+      if (delay_in_ms > 0) {
+        co_await pause(delay_in_ms);
+      }
+      if (pos) {
+        auto result = m_monitor->set_cursor(*pos);
+        if (result != 0) {
+          co_return result;
+        }
+      }
+      // The delay has already been waited for:
+      m_monitor->set_text_delay(0);
+      auto result = m_monitor->print(std::string(1, character));
+      m_monitor->set_text_delay(delay_in_ms);
+      if (result != 0) {
+        co_return result;
+      }
+      if (pos) {
+        pos = m_monitor->get_cursor_position();
+      }
+    }
+    co_return 0;
+  }
+
+  Remotemo* m_monitor;
+  std::vector<std::coroutine_handle<detail::Spawned::promise_type>>
+      m_spawned {};
+};
+} // namespace remotemo::co
+#endif // REMOTEMO_COROUTINES_HPP
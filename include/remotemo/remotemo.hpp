@@ -9,9 +9,11 @@
 #ifndef REMOTEMO_REMOTEMO_HPP
 #define REMOTEMO_REMOTEMO_HPP
 
+#include <iosfwd>
 #include <string>
 #include <optional>
 #include <memory>
+#include <functional>
 
 #include "remotemo/exceptions.hpp"
 #include "remotemo/common_types.hpp"
@@ -20,6 +22,106 @@
 /// \brief Main namespace of the remoTemo library
 namespace remotemo {
 class Engine;
+class Command_queue;
+
+////////////////////////////////////////////////////////////////////////
+
+/** \brief A handle that lets other threads send output to the monitor
+ *
+ * Got from \c Remotemo::handle(). Unlike the \c remotemo::Remotemo object
+ * itself, a handle can be copied and used from any thread. Its member
+ * functions never wait, neither for the rendering nor for the delay between
+ * characters: they only queue the request and return at once.
+ *
+ * The queued requests get carried out, in the order they were made, by the
+ * thread that owns the \c remotemo::Remotemo object, the next time it
+ * updates the window, i.e. while it is waiting (e.g. in \c get_key() or \c
+ * pause()) or in between the outputs it is doing itself (but never in the
+ * middle of one, e.g. while printing a string).
+ *
+ * If the monitor no longer exists, any request is silently dropped.
+ */
+class Handle {
+  friend class Remotemo;
+
+public:
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Queue printing of the given text at the cursor's position
+   *
+   * \param text The text to be printed
+   *
+   * \sa Remotemo::print()
+   */
+  void print(const std::string& text) const;
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Queue moving the cursor to the given position
+   *
+   * If the position turns out to be outside of the text area, the request
+   * is ignored.
+   *
+   * \param column The column to move the cursor to
+   * \param line   The line to move the cursor to
+   *
+   * \sa Remotemo::set_cursor()
+   */
+  void set_cursor(int column, int line) const
+  {
+    set_cursor(Point {column, line});
+  }
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \overload
+   *
+   * \param position The position to move the cursor to
+   */
+  void set_cursor(const Point& position) const;
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Queue setting the \c inverse property
+   *
+   * \param inverse New setting of the property
+   *
+   * \sa Remotemo::set_inverse()
+   */
+  void set_inverse(bool inverse) const;
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Queue clearing the screen
+   *
+   * \param do_reset What properties should be reset (\b default: all)
+   *
+   * \sa Remotemo::clear()
+   */
+  void clear(Do_reset do_reset = Do_reset::all) const;
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Makes the rest of the text being printed go out at once
+   *
+   * Has the same effect as pressing the key set with \c
+   * Config::key_skip_animation(): if \c Remotemo::print() (or the printing
+   * of queued text) is in progress, then the rest of its text gets printed
+   * without the delay between characters, and rendered once. Printing goes
+   * back to the normal speed afterwards.
+   *
+   * Does nothing if nothing is being printed.
+   *
+   * \sa Config::key_skip_animation()
+   */
+  void skip_animation() const;
+
+private:
+  explicit Handle(std::weak_ptr<Command_queue> command_queue) noexcept
+      : m_command_queue(std::move(command_queue))
+  {}
+  std::weak_ptr<Command_queue> m_command_queue;
+};
 
 ////////////////////////////////////////////////////////////////////////
 
@@ -238,6 +340,112 @@ public:
 
   //////////////////////////////////////////////////////////////////////
 
+  /** \brief Runs a loop with a fixed time step, until told to stop.
+   *
+   * The function \c update_fn gets called \c steps_per_second times per
+   * second, each time with the keys pressed since the previous step. In
+   * between, the events get handled and the window updated as needed (the
+   * same way as while waiting in \c get_key()).
+   *
+   * If a step (along with the rendering) takes longer than it should, then
+   * the following ones are run without rendering in between until the loop
+   * has caught up. If it falls more than a few steps behind, then the steps
+   * it is unable to catch up with get dropped. Both are counted in \c
+   * stats().
+   *
+   * \note The functions for output (e.g. \c print()) can be used from
+   * within \c update_fn, but keep in mind that they do wait (e.g. for the
+   * delay between characters, see \c set_text_delay()), which counts
+   * towards the time of the step.
+   *
+   * \param update_fn Called for each step. Should return \c false to stop
+   * the loop, otherwise \c true.
+   * \param steps_per_second How many steps per second (1 to 1000).
+   *
+   * \return
+   * \retval  0 if \c update_fn stopped the loop.
+   * \retval -1 if \c steps_per_second is out of range.
+   *
+   * \sa Run_step
+   * \sa Render_stats::steps_overrun
+   * \sa Render_stats::steps_dropped
+   */
+  int run(const std::function<bool(const Run_step&)>& update_fn,
+      // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
+      int steps_per_second = 60);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Schedules a function to be called after a delay
+   *
+   * The function gets called by \c run_scheduled(), on the thread that owns
+   * this object, once the delay has passed (going by the clock set with \c
+   * Config::clock()).
+   *
+   * This, along with \c schedule_on_key() and \c run_scheduled(), is what
+   * the coroutines in \c remotemo/coroutines.hpp build on, but they can
+   * also be used directly.
+   *
+   * \param delay_in_ms The delay (in milliseconds).
+   * \param task_fn The function to call.
+   *
+   * \return
+   * \retval  0 on success.
+   * \retval -1 if \c delay_in_ms is negative.
+   *
+   * \sa run_scheduled()
+   */
+  int schedule(int delay_in_ms, std::function<void()> task_fn);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Schedules a function to be called with the next key pressed
+   *
+   * If more than one function is waiting for a key, then each key goes to
+   * the one that has waited the longest.
+   *
+   * \param task_fn The function to call.
+   *
+   * \sa run_scheduled()
+   */
+  void schedule_on_key(std::function<void(Key)> task_fn);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Calls the scheduled functions as they become due, until nothing
+   * is scheduled any more
+   *
+   * Meanwhile, the events get handled and the window updated as needed (the
+   * same way as while waiting in \c get_key()).
+   *
+   * \note The scheduled functions should not wait (e.g. by calling \c
+   * pause()), since everything else that is scheduled would have to wait
+   * as well. Rather schedule what comes next.
+   *
+   * \return
+   * \retval  0 when nothing is scheduled any more.
+   * \retval -1 if called from within a scheduled function.
+   *
+   * \sa schedule()
+   * \sa schedule_on_key()
+   * \sa cancel_scheduled()
+   */
+  int run_scheduled();
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Drops everything scheduled, without calling it
+   *
+   * Can also be called from within a scheduled function, in which case \c
+   * run_scheduled() returns once that function does.
+   *
+   * \sa schedule()
+   * \sa schedule_on_key()
+   */
+  void cancel_scheduled();
+
+  //////////////////////////////////////////////////////////////////////
+
   /** \brief Allows the user to enter some text (NOT IMPLEMENTED YET)
    *
    * \todo Implement this function
@@ -282,8 +490,10 @@ public:
    * \retval -2 if some of the text could not get displayed (e.g. reached end
    *         of line while wrapping was set to off).
    *
-   * \warning Any non-ASCII character will be displayed as �. This will not
-   * count as "text could not get displayed".
+   * \note The text is taken to be UTF-8. Any character that is not in the
+   * font (see \c Config::font_bitmap_file_path()) gets displayed as �,
+   * which will not count as "text could not get displayed". Neither will an
+   * invalid UTF-8 sequence. A character may be split between two calls.
    *
    * \note If the inverse property is set to true, the string will be
    * displayed with the foreground and background colors switched.
@@ -304,6 +514,7 @@ public:
    * \sa set_wrapping()
    * \sa Wrapping for more info on how wrapping behaves
    * \sa set_inverse()
+   * \sa set_escape_sequences()
    */
   int print(const std::string& text);
 
@@ -344,13 +555,56 @@ public:
 
   //////////////////////////////////////////////////////////////////////
 
+  /** \brief Display all the text read from the given stream
+   *
+   * Behaves as \c print() would with all of the text, except that the
+   * text gets read (and printed) a chunk at a time, so that the memory used
+   * stays the same whatever the size of the input.
+   *
+   * When the delay between characters is 0, only the screen as it ends up
+   * gets rendered, which makes this the fastest way to fill the screen (and
+   * the scrollback) with a lot of text.
+   *
+   * \param input The stream to read the text from, until its end (or until
+   *              something can not get displayed)
+   * \retval 0 on success.
+   * \retval -1 if reading from the stream failed (after printing what had
+   *         been read).
+   * \retval -2 if some of the text could not get displayed (see \c
+   *         print()). The rest of the stream is not read.
+   *
+   * \sa print()
+   * \sa print_file()
+   */
+  int print_stream(std::istream& input);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Display all the text of the given file
+   *
+   * The same as \c print_stream(), reading from the file.
+   *
+   * \param file_path The file to print
+   * \retval 0 on success.
+   * \retval -1 if the file could not be opened, or reading from it failed.
+   * \retval -2 if some of the text could not get displayed.
+   *
+   * \sa print_stream()
+   */
+  int print_file(const std::string& file_path);
+
+  //////////////////////////////////////////////////////////////////////
+
   /** \brief Return the character at the given position of the screen
    *
    * \param column Column of the given position
    * \param line Row of the given position
    *
    * \retval 0 ('\\0') if the given position is outside the text area.
+   * \retval 1 if the character displayed there is not ASCII.
    * \return The character that is displayed at the given position.
+   *
+   * \sa get_code_point_at()
    */
   [[nodiscard]] char get_char_at(int column, int line) const
   {
@@ -364,12 +618,47 @@ public:
    * for \c column and \c y for \c line.
    *
    * \retval 0 ('\\0') if the given position is outside the text area.
+   * \retval 1 if the character displayed there is not ASCII.
    * \return The character that is displayed at the given position.
    */
   [[nodiscard]] char get_char_at(const Point& pos) const;
 
   //////////////////////////////////////////////////////////////////////
 
+  /** \brief Return the code point of the character at the given position
+   * of the screen
+   *
+   * Unlike \c get_char_at(), this also tells which non-ASCII character is
+   * displayed.
+   *
+   * \param column Column of the given position
+   * \param line Row of the given position
+   *
+   * \retval 0 if the given position is outside the text area.
+   * \retval 0xFFFD if the character displayed there is not in the font.
+   * \return The Unicode code point of the character that is displayed at
+   * the given position.
+   */
+  [[nodiscard]] char32_t get_code_point_at(int column, int line) const
+  {
+    return get_code_point_at(Point {column, line});
+  }
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \overload
+   * \param pos \c remotemo::Point containing the desired position, \c x
+   * for \c column and \c y for \c line.
+   *
+   * \retval 0 if the given position is outside the text area.
+   * \retval 0xFFFD if the character displayed there is not in the font.
+   * \return The Unicode code point of the character that is displayed at
+   * the given position.
+   */
+  [[nodiscard]] char32_t get_code_point_at(const Point& pos) const;
+
+  //////////////////////////////////////////////////////////////////////
+
   /** \brief Check if foreground and background colors are inversed at given
    * position
    *
@@ -495,7 +784,61 @@ public:
    * \return The current state of the \c wrapping property
    * \sa set_wrapping()
    */
-  [[nodiscard]] Wrapping get_wrapping() const { return m_text_wrapping; }
+  [[nodiscard]] Wrapping get_wrapping() const;
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Set the \c escape_sequences property
+   *
+   * While set to \c true, \c print() (and \c print_at()) understand a
+   * subset of the ANSI/VT100 escape sequences, so that e.g. a whole
+   * formatted screen can be printed at once, or output meant for a terminal
+   * can be printed as it is:
+   *   - <tt>ESC [ n A</tt>, <tt>ESC [ n B</tt>, <tt>ESC [ n C</tt> and
+   *     <tt>ESC [ n D</tt> move the cursor \c n (default 1) squares up,
+   *     down, right and left (but not past the border).
+   *   - <tt>ESC [ line ; column H</tt> (or \c f) moves the cursor to the
+   *     given position, counting from 1 (the default).
+   *   - <tt>ESC [ n m</tt> with \c n being 7 sets the \c inverse property
+   *     to \c true, 27 or 0 (the default) to \c false. Other values are
+   *     ignored.
+   *   - <tt>ESC [ n K</tt> erases (from the cursor) to the end of the line
+   *     when \c n is 0 (the default), to the start of the line when 1 and
+   *     the whole line when 2. Other values are ignored.
+   *   - <tt>ESC [ n J</tt> erases the same way as \c K, but to the end (or
+   *     start) of the text area when \c n is 0 (or 1) and the whole text
+   *     area when 2. Other values (e.g. 3, for erasing the scrollback in
+   *     some terminals) are ignored. The cursor does not move.
+   *   - What gets erased is left blank and not inversed, the same way as
+   *     with \c clear(), whatever the \c inverse property is set to.
+   *   - <tt>ESC [ top ; bottom r</tt> makes only the lines from \c top to
+   *     \c bottom (counting from 1) scroll, when going to a new line from
+   *     the \c bottom line, and moves the cursor to the top left corner.
+   *     Without the numbers, all of the text area scrolls again.
+   *   - The \c carriage \c return character moves the cursor to the start of
+   *     the line.
+   *
+   * Any other escape sequence is dropped without anything being printed.
+   * A sequence can be split over more than one call to \c print().
+   *
+   * \param is_parsing New setting of the property (\b default: \c false)
+   *
+   * \note Changing the property drops any sequence half printed and the
+   * scroll region.
+   *
+   * \sa print()
+   * \sa get_escape_sequences()
+   */
+  void set_escape_sequences(bool is_parsing);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Get the \c escape_sequences property
+   *
+   * \return The current state of the \c escape_sequences property
+   * \sa set_escape_sequences()
+   */
+  [[nodiscard]] bool get_escape_sequences() const;
 
   //////////////////////////////////////////////////////////////////////
 
@@ -522,10 +865,195 @@ public:
    */
   [[nodiscard]] bool get_inverse() const;
 
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Get the time spent in each phase of starting up
+   *
+   * Only measured if asked for with \c Config::startup_timing(). The
+   * timings of the first rendering of the window stay empty until the window
+   * has been rendered (which happens the first time anything waits, e.g. \c
+   * print() or \c pause()).
+   *
+   * \return The timings or, if they were not measured, \c std::nullopt
+   *
+   * \sa Config::startup_timing()
+   * \sa Startup_timings
+   */
+  [[nodiscard]] std::optional<Startup_timings> startup_timings() const;
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Get what renderer is actually being used
+   *
+   * Useful for checking what the settings in \c Config::renderer() led to,
+   * since SDL might have fallen back to another driver than the preferred
+   * one.
+   *
+   * \return The info on the renderer, or nothing if SDL failed to provide
+   * it.
+   *
+   * \sa Renderer_info
+   */
+  [[nodiscard]] std::optional<Renderer_info> renderer_info() const;
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Get the statistics of the rendering
+   *
+   * Those are collected all the time, since the object was created or since
+   * the last time they were reset.
+   *
+   * \return Counters and timings of the rendering
+   *
+   * \sa reset_stats()
+   * \sa Render_stats
+   */
+  [[nodiscard]] Render_stats stats() const;
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Resets all the statistics of the rendering to zero
+   *
+   * \sa stats()
+   */
+  void reset_stats();
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Move the view over a text area that is larger than the screen
+   *
+   * Sets which column and line of the text area (see \c
+   * Config::text_canvas_size()) is shown at the top left corner of the
+   * screen. Moving the view does not affect the content of the text area nor
+   * the cursor.
+   *
+   * \param column The column to show at the left edge of the screen
+   * \param line   The line to show at the top edge of the screen
+   *
+   * \retval 0 on success.
+   * \retval -1 if the view would have gone outside of the text area, in
+   *         which case it moves as far as it can.
+   *
+   * \sa get_view_position()
+   * \sa Config::text_canvas_size()
+   */
+  int set_view_position(int column, int line)
+  {
+    return set_view_position(Point {column, line});
+  }
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \overload
+   *
+   * \param position The position in the text area to show at the top left
+   *                 corner of the screen
+   */
+  int set_view_position(const Point& position);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Get the position of the view over the text area
+   *
+   * \return The column and line shown at the top left corner of the screen
+   *
+   * \sa set_view_position()
+   */
+  [[nodiscard]] Point get_view_position() const;
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Scroll the view back into the scrollback
+   *
+   * Shows the text area as it was \p lines_back lines ago, i.e. with that
+   * many of the lines that have been scrolled off its top (and kept, see \c
+   * Config::scrollback_lines()) shown above it. With 0 the view shows the
+   * text area as it is.
+   *
+   * Printing anything, or clearing the screen, brings the view back to
+   * showing the text area as it is.
+   *
+   * \param lines_back Number of lines to scroll the view back
+   *
+   * \retval 0 on success.
+   * \retval -1 if \p lines_back was negative or more than the number of
+   *         lines kept, in which case the view is scrolled as far as it can.
+   *
+   * \sa get_scrollback_view()
+   * \sa get_scrollback_size()
+   * \sa Config::key_scroll_back()
+   */
+  int set_scrollback_view(int lines_back);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Get how many lines the view is scrolled back
+   *
+   * \return Number of lines the view is scrolled back (0 if showing the text
+   *         area as it is)
+   *
+   * \sa set_scrollback_view()
+   */
+  [[nodiscard]] int get_scrollback_view() const;
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Get how many lines are kept in the scrollback
+   *
+   * \return Number of lines that the view can be scrolled back
+   *
+   * \sa set_scrollback_view()
+   * \sa Config::scrollback_lines()
+   */
+  [[nodiscard]] int get_scrollback_size() const;
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Replay a recorded session
+   *
+   * Re-runs the operations recorded to the given trace file (see \c
+   * Config::record_session_file()), in the same order, on this monitor.
+   *
+   * With \c Replay_speed::original each operation is done at the same time
+   * (relative to when the replay started) as when it was recorded. With \c
+   * Replay_speed::as_fast_as_possible there is no waiting at all (the delay
+   * between characters is set to 0 while replaying). Either way, the delay
+   * between characters is the same afterwards as before the replay.
+   *
+   * Keys that were returned by \c get_key() during the recording are not
+   * fed to anything, but the time the program spent waiting for them is
+   * replayed (at the original speed).
+   *
+   * If this monitor is recording a session as well, then nothing done by
+   * the replay gets recorded.
+   *
+   * \param trace_file The file that the session was recorded to
+   * \param speed      How fast to replay the session (\b default:
+   *                   \c Replay_speed::original)
+   *
+   * \retval 0 on success.
+   * \retval -1 if the file could not be opened or is not a trace file.
+   * \retval -2 if the file turned out to be malformed (after replaying as
+   *            much of it as could be read).
+   *
+   * \sa Config::record_session_file()
+   */
+  int replay(const std::string& trace_file,
+      Replay_speed speed = Replay_speed::original);
+
+  //////////////////////////////////////////////////////////////////////
+
+  /** \brief Get a handle for sending output from other threads
+   *
+   * \return A handle that can be copied and used from any thread
+   *
+   * \sa Handle
+   */
+  [[nodiscard]] Handle handle() const;
+
 private:
   Remotemo(std::unique_ptr<Engine> engine, const Config& config) noexcept;
   std::unique_ptr<Engine> m_engine {};
-  Wrapping m_text_wrapping {Wrapping::character};
 };
 
 ////////////////////////////////////////////////////////////////////////
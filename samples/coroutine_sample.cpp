@@ -0,0 +1,49 @@
+#include <string>
+
+#include <remotemo/coroutines.hpp>
+
+namespace {
+remotemo::co::Task<> counter(remotemo::co::Monitor& mon, bool* is_done)
+{
+  for (int count = 0; !*is_done; count++) {
+    co_await mon.print_at({30, 2}, std::to_string(count));
+    co_await mon.pause(1000);
+  }
+}
+
+remotemo::co::Task<> ticker(remotemo::co::Monitor& mon, bool* is_done)
+{
+  const std::string text {"*** remoTemo - the retro monochrome text "
+                          "monitor *** "};
+  constexpr std::size_t shown_length {30};
+  for (std::size_t offset = 0; !*is_done; offset++) {
+    offset %= text.size();
+    auto shown = text.substr(offset) + text.substr(0, offset);
+    co_await mon.print_at({5, 20}, shown.substr(0, shown_length));
+    co_await mon.pause(250);
+  }
+}
+
+remotemo::co::Task<> prompt(remotemo::co::Monitor& mon, bool* is_done)
+{
+  co_await mon.print_at({2, 8}, "Press any key to quit");
+  co_await mon.key();
+  *is_done = true;
+}
+} // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
+{
+  auto text_monitor = remotemo::create();
+  if (!text_monitor) {
+    return -1;
+  }
+  text_monitor->set_text_delay(20);
+
+  remotemo::co::Monitor mon {*text_monitor};
+  bool is_done = false;
+  mon.spawn(counter(mon, &is_done));
+  mon.spawn(ticker(mon, &is_done));
+  mon.spawn(prompt(mon, &is_done));
+  return mon.run();
+}
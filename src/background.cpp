@@ -3,11 +3,12 @@
 namespace remotemo {
 std::optional<Background> Background::create(
     const Backgr_config& backgr_config,
-    Res_handler<SDL_Texture>&& backgr_texture, SDL_Renderer* renderer)
+    Res_handler<SDL_Texture>&& backgr_texture,
+    Surface_loader&& backgr_surface, SDL_Renderer* renderer)
 {
   Background backgr {backgr_config, Texture {std::move(backgr_texture)}};
   if (backgr_config.raw_sdl == nullptr) {
-    if (!backgr.load(renderer, backgr_config.file_path)) {
+    if (!backgr.load(renderer, std::move(backgr_surface))) {
       return {};
     }
   }
@@ -20,7 +20,8 @@ public:
   {}
 
   static std::optional<Background> create(const Backgr_config& backgr_config,
-      Res_handler<SDL_Texture>&& backgr_texture, SDL_Renderer* renderer);
+      Res_handler<SDL_Texture>&& backgr_texture,
+      Surface_loader&& backgr_surface, SDL_Renderer* renderer);
   [[nodiscard]] const Rect<int>& min_area() const { return m_min_area; }
   [[nodiscard]] const Rect<float>& text_area() const { return m_text_area; }
 
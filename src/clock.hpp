@@ -0,0 +1,32 @@
+#ifndef REMOTEMO_SRC_CLOCK_HPP
+#define REMOTEMO_SRC_CLOCK_HPP
+
+#include "remotemo/common_types.hpp"
+#include "stopwatch.hpp"
+
+namespace remotemo {
+// The time as the engine sees it. With Clock_mode::simulated, time only
+// moves when the engine advances it (i.e. when it is supposed to wait).
+class Clock {
+public:
+  explicit Clock(Clock_mode mode) noexcept : m_mode(mode) {}
+
+  [[nodiscard]] Clock_mode mode() const { return m_mode; }
+  [[nodiscard]] bool is_simulated() const
+  {
+    return m_mode == Clock_mode::simulated;
+  }
+  // Milliseconds since the clock was created.
+  [[nodiscard]] double now_ms() const
+  {
+    return is_simulated() ? m_simulated_ms : m_stopwatch.total_ms();
+  }
+  void advance(double time_ms) { m_simulated_ms += time_ms; }
+
+private:
+  Clock_mode m_mode;
+  Stopwatch m_stopwatch {};
+  double m_simulated_ms {0.0};
+};
+} // namespace remotemo
+#endif // REMOTEMO_SRC_CLOCK_HPP
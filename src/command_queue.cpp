@@ -0,0 +1,74 @@
+#include "command_queue.hpp"
+
+#include <utility>
+
+namespace remotemo {
+namespace {
+// SDL only has so many event types to hand out (and never takes any back),
+// so the queues of all the monitors share the one:
+Uint32 wakeup_event_type()
+{
+  static const Uint32 event_type = ::SDL_RegisterEvents(1);
+  return event_type;
+}
+} // namespace
+
+Command_queue::Command_queue() : m_head(new Node {}), m_tail(m_head.load())
+{
+  // Registered here, on the thread creating the monitor, rather than by
+  // whichever producer first pushes something:
+  wakeup_event_type();
+}
+
+Command_queue::~Command_queue()
+{
+  while (m_tail != nullptr) {
+    auto* next = m_tail->next.load(std::memory_order_acquire);
+    delete m_tail; // NOLINT(cppcoreguidelines-owning-memory)
+    m_tail = next;
+  }
+}
+
+void Command_queue::push(Command&& command)
+{
+  // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+  auto* node = new Node {nullptr, std::move(command)};
+  auto* prev = m_head.exchange(node, std::memory_order_acq_rel);
+  prev->next.store(node, std::memory_order_release);
+  wake_up();
+}
+
+void Command_queue::request_skip()
+{
+  m_is_skip_requested.store(true);
+  wake_up();
+}
+
+void Command_queue::wake_up()
+{
+  // The consumer might be waiting for events (e.g. in get_key()). Wake it
+  // up, but without flooding the event queue:
+  const auto event_type = wakeup_event_type();
+  if (event_type != static_cast<Uint32>(-1) &&
+      !m_is_wakeup_pending.exchange(true)) {
+    SDL_Event event {};
+    event.type = event_type;
+    ::SDL_PushEvent(&event);
+  }
+}
+
+std::optional<Command> Command_queue::pop()
+{
+  auto* next = m_tail->next.load(std::memory_order_acquire);
+  if (next == nullptr) {
+    // Empty (or a producer is just about to link in its command, in which
+    // case it will be there the next time).
+    return {};
+  }
+  delete m_tail; // NOLINT(cppcoreguidelines-owning-memory)
+  m_tail = next;
+  auto command = std::move(m_tail->command);
+  m_tail->command.reset();
+  return command;
+}
+} // namespace remotemo
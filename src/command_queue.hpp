@@ -0,0 +1,62 @@
+#ifndef REMOTEMO_SRC_COMMAND_QUEUE_HPP
+#define REMOTEMO_SRC_COMMAND_QUEUE_HPP
+
+#include <atomic>
+#include <optional>
+#include <string>
+
+#include "remotemo/common_types.hpp"
+#include <SDL.h>
+
+namespace remotemo {
+struct Command {
+  enum class Type { print, set_cursor, set_inverse, clear };
+
+  Type type;
+  std::string text {};
+  Point pos {0, 0};
+  bool is_inversed {false};
+  Do_reset do_reset {Do_reset::all};
+};
+
+// Lock-free queue with any number of producers (on any thread) but a single
+// consumer (the thread that owns the engine).
+// Based on Dmitry Vyukov's intrusive MPSC node-based queue.
+class Command_queue {
+public:
+  Command_queue();
+  ~Command_queue();
+  Command_queue(Command_queue&&) = delete;
+  Command_queue& operator=(Command_queue&&) = delete;
+  Command_queue(const Command_queue&) = delete;
+  Command_queue& operator=(const Command_queue&) = delete;
+
+  // Can be called from any thread. Never waits for the consumer.
+  void push(Command&& command);
+  // Must only be called from the consumer thread.
+  std::optional<Command> pop();
+  // Called by the consumer once it has started popping the commands, so that
+  // the next push will wake it up again.
+  void wakeup_handled() { m_is_wakeup_pending.store(false); }
+
+  // Can be called from any thread. Asks for the rest of the text being
+  // printed to go out at once.
+  void request_skip();
+  // Returns whether skipping has been asked for (since the last time).
+  bool take_skip_request() { return m_is_skip_requested.exchange(false); }
+
+private:
+  void wake_up();
+
+  struct Node {
+    std::atomic<Node*> next {nullptr};
+    std::optional<Command> command {};
+  };
+
+  std::atomic<Node*> m_head;
+  Node* m_tail;
+  std::atomic<bool> m_is_wakeup_pending {false};
+  std::atomic<bool> m_is_skip_requested {false};
+};
+} // namespace remotemo
+#endif // REMOTEMO_SRC_COMMAND_QUEUE_HPP
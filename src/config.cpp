@@ -6,6 +6,37 @@ Config& Config::cleanup_all(bool cleanup_all)
   m_cleanup_all = cleanup_all;
   return *this;
 }
+Config& Config::startup_timing(Startup_timing_mode mode)
+{
+  m_startup_timing = mode;
+  return *this;
+}
+
+Config& Config::clock(Clock_mode mode)
+{
+  m_clock_mode = mode;
+  return *this;
+}
+
+Config& Config::scaling(Scaling_mode mode)
+{
+  m_scaling_mode = mode;
+  return *this;
+}
+
+Config& Config::capture_frames(
+    const std::string& path_prefix, Capture_format format)
+{
+  m_capture_path_prefix = path_prefix;
+  m_capture_format = format;
+  return *this;
+}
+
+Config& Config::record_session_file(const std::string& file_path)
+{
+  m_record_session_file = file_path;
+  return *this;
+}
 
 Config& Config::window(SDL_Window* window)
 {
@@ -48,6 +79,36 @@ Config& Config::window_fullscreen(bool is_fullscreen)
   return *this;
 }
 
+Config& Config::renderer(const Renderer_config& renderer)
+{
+  m_renderer = renderer;
+  return *this;
+}
+
+Config& Config::renderer_driver(const std::string& driver)
+{
+  m_renderer.driver = driver;
+  return *this;
+}
+
+Config& Config::renderer_acceleration(Renderer_acceleration acceleration)
+{
+  m_renderer.acceleration = acceleration;
+  return *this;
+}
+
+Config& Config::renderer_vsync(bool is_vsync)
+{
+  m_renderer.is_vsync = is_vsync;
+  return *this;
+}
+
+Config& Config::renderer_requires_target_texture(bool is_required)
+{
+  m_renderer.is_target_texture_required = is_required;
+  return *this;
+}
+
 Config& Config::key_fullscreen()
 {
   m_key_fullscreen = std::nullopt;
@@ -120,6 +181,78 @@ Config& Config::key_quit(Mod_keys_strict modifier_keys, Key key)
   return *this;
 }
 
+Config& Config::key_scroll_back()
+{
+  m_key_scroll_back = std::nullopt;
+  return *this;
+}
+Config& Config::key_scroll_back(Mod_keys modifier_keys, F_key key)
+{
+  if (m_key_scroll_back) {
+    m_key_scroll_back->set(modifier_keys, key);
+  } else {
+    m_key_scroll_back.emplace(modifier_keys, key);
+  }
+  return *this;
+}
+Config& Config::key_scroll_back(Mod_keys_strict modifier_keys, Key key)
+{
+  if (m_key_scroll_back) {
+    m_key_scroll_back->set(modifier_keys, key);
+  } else {
+    m_key_scroll_back.emplace(modifier_keys, key);
+  }
+  return *this;
+}
+
+Config& Config::key_scroll_forward()
+{
+  m_key_scroll_forward = std::nullopt;
+  return *this;
+}
+Config& Config::key_scroll_forward(Mod_keys modifier_keys, F_key key)
+{
+  if (m_key_scroll_forward) {
+    m_key_scroll_forward->set(modifier_keys, key);
+  } else {
+    m_key_scroll_forward.emplace(modifier_keys, key);
+  }
+  return *this;
+}
+Config& Config::key_scroll_forward(Mod_keys_strict modifier_keys, Key key)
+{
+  if (m_key_scroll_forward) {
+    m_key_scroll_forward->set(modifier_keys, key);
+  } else {
+    m_key_scroll_forward.emplace(modifier_keys, key);
+  }
+  return *this;
+}
+
+Config& Config::key_skip_animation()
+{
+  m_key_skip_animation = std::nullopt;
+  return *this;
+}
+Config& Config::key_skip_animation(Mod_keys modifier_keys, F_key key)
+{
+  if (m_key_skip_animation) {
+    m_key_skip_animation->set(modifier_keys, key);
+  } else {
+    m_key_skip_animation.emplace(modifier_keys, key);
+  }
+  return *this;
+}
+Config& Config::key_skip_animation(Mod_keys_strict modifier_keys, Key key)
+{
+  if (m_key_skip_animation) {
+    m_key_skip_animation->set(modifier_keys, key);
+  } else {
+    m_key_skip_animation.emplace(modifier_keys, key);
+  }
+  return *this;
+}
+
 Config& Config::closing_same_as_quit(bool is_closing_same_as_quit)
 {
   m_is_closing_same_as_quit = is_closing_same_as_quit;
@@ -193,6 +326,11 @@ Config& Config::font_size(const Size& size)
 {
   return font_size(size.width, size.height);
 }
+Config& Config::font_psf_file(const std::string& file_path)
+{
+  m_font.psf_file_path = file_path;
+  return *this;
+}
 
 Config& Config::text_area_size(int columns, int lines)
 {
@@ -204,6 +342,16 @@ Config& Config::text_area_size(const Size& size)
 {
   return text_area_size(size.width, size.height);
 }
+Config& Config::text_canvas_size(int columns, int lines)
+{
+  m_text_area.canvas_columns = columns;
+  m_text_area.canvas_lines = lines;
+  return *this;
+}
+Config& Config::text_canvas_size(const Size& size)
+{
+  return text_canvas_size(size.width, size.height);
+}
 Config& Config::text_blend_mode(SDL_BlendMode mode)
 {
   m_text_area.blend_mode = mode;
@@ -218,6 +366,21 @@ Config& Config::text_color(const Color& color)
   m_text_area.color = color;
   return *this;
 }
+Config& Config::scrollback_lines(int lines)
+{
+  m_text_area.scrollback_lines = lines;
+  return *this;
+}
+Config& Config::line_cache_lines(int lines)
+{
+  m_text_area.line_cache_lines = lines;
+  return *this;
+}
+Config& Config::text_double_buffered(bool is_double_buffered)
+{
+  m_text_area.is_double_buffered = is_double_buffered;
+  return *this;
+}
 
 bool Config::validate_texture(SDL_Texture* texture, SDL_Renderer* renderer,
     const std::string& texture_name)
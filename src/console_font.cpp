@@ -0,0 +1,534 @@
+#include "console_font.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <climits>
+#include <memory>
+#include <utility>
+
+#include "font.hpp"
+#include "utf8_decoder.hpp"
+
+namespace remotemo {
+namespace {
+constexpr std::string_view psf1_magic {"\x36\x04"};
+constexpr std::size_t psf1_header_size {4};
+constexpr unsigned psf1_mode_512 {0x01};
+constexpr unsigned psf1_mode_has_table {0x06};
+constexpr int psf1_glyph_width {8};
+constexpr int psf1_glyph_count {256};
+constexpr unsigned psf1_sequence_start {0xfffe};
+constexpr unsigned psf1_glyph_end {0xffff};
+
+constexpr std::string_view psf2_magic {"\x72\xb5\x4a\x86"};
+constexpr std::size_t psf2_header_size {32};
+constexpr std::size_t psf2_header_size_offset {8};
+constexpr std::size_t psf2_flags_offset {12};
+constexpr std::size_t psf2_length_offset {16};
+constexpr std::size_t psf2_charsize_offset {20};
+constexpr std::size_t psf2_height_offset {24};
+constexpr std::size_t psf2_width_offset {28};
+constexpr Uint32 psf2_flag_has_table {0x01};
+constexpr unsigned char psf2_sequence_start {0xfe};
+constexpr unsigned char psf2_glyph_end {0xff};
+
+constexpr std::string_view bdf_magic {"STARTFONT"};
+
+// Anything larger would make for a huge font bitmap:
+constexpr int max_glyph_size {64};
+constexpr int bits_per_hex_digit {4};
+constexpr unsigned top_bit_of_byte {0x80};
+constexpr unsigned top_bit_of_hex_digit {0x8};
+constexpr int bytes_per_pixel {3};
+constexpr Uint8 max_intensity {255};
+// What Text_display shows any character that is not in the font with:
+constexpr Glyph not_in_font_glyph {1};
+// What Text_display shows the cursor with, which is made a full block:
+constexpr Glyph cursor_glyph {0};
+constexpr char32_t full_block {0x2588};
+
+unsigned read_le(std::string_view bytes, std::size_t offset, int size)
+{
+  unsigned value {0};
+  for (int i = size - 1; i >= 0; i--) {
+    value = (value << CHAR_BIT) |
+            static_cast<unsigned char>(bytes[offset + i]);
+  }
+  return value;
+}
+
+// The place of the character in the pages of the font bitmap, if it has
+// one.
+std::optional<std::size_t> slot_of(char32_t code_point)
+{
+  for (std::size_t page = 0; page < Font::page_first_code_points.size();
+       page++) {
+    const auto first = Font::page_first_code_points[page];
+    if (code_point >= first && code_point < first + Font::glyphs_per_page) {
+      return page * Font::glyphs_per_page + (code_point - first);
+    }
+  }
+  return {};
+}
+
+bool is_control(char32_t code_point)
+{
+  constexpr char32_t first_printable {0x20};
+  constexpr char32_t first_c1_control {0x80};
+  constexpr char32_t first_after_c1 {0xa0};
+  return code_point < first_printable ||
+         (code_point >= first_c1_control && code_point < first_after_c1);
+}
+
+// Returns the first line of the text, and removes it (and its line break)
+// from the text.
+std::string_view next_line(std::string_view* text)
+{
+  auto end = text->find('\n');
+  auto line = text->substr(0, end);
+  text->remove_prefix(end == std::string_view::npos ? text->size() : end + 1);
+  if (!line.empty() && line.back() == '\r') {
+    line.remove_suffix(1);
+  }
+  return line;
+}
+
+// Returns the first word of the line, and removes it from the line.
+std::string_view next_word(std::string_view* line)
+{
+  auto start = line->find_first_not_of(" \t");
+  if (start == std::string_view::npos) {
+    *line = {};
+    return {};
+  }
+  line->remove_prefix(start);
+  auto end = line->find_first_of(" \t");
+  auto word = line->substr(0, end);
+  line->remove_prefix(word.size());
+  return word;
+}
+
+std::optional<int> next_int(std::string_view* line)
+{
+  auto word = next_word(line);
+  int value {0};
+  auto [end, error] =
+      std::from_chars(word.data(), word.data() + word.size(), value);
+  if (word.empty() || error != std::errc {} ||
+      end != word.data() + word.size()) {
+    return {};
+  }
+  return value;
+}
+
+std::optional<unsigned> hex_digit(char digit)
+{
+  constexpr unsigned ten {10};
+  if (digit >= '0' && digit <= '9') {
+    return static_cast<unsigned>(digit - '0');
+  }
+  if (digit >= 'a' && digit <= 'f') {
+    return static_cast<unsigned>(digit - 'a') + ten;
+  }
+  if (digit >= 'A' && digit <= 'F') {
+    return static_cast<unsigned>(digit - 'A') + ten;
+  }
+  return {};
+}
+} // namespace
+
+std::optional<Console_font> Console_font::create(const std::string& file_path)
+{
+  auto file = Mapped_file::create(file_path);
+  if (!file) {
+    return {};
+  }
+  const auto bytes = file->bytes();
+  auto shared_file = std::make_shared<const Mapped_file>(std::move(*file));
+  const bool is_bdf = bytes.substr(0, bdf_magic.size()) == bdf_magic;
+  Console_font font {std::move(shared_file), file_path,
+      is_bdf ? Format::bdf : Format::psf};
+  font.m_glyphs.resize(
+      static_cast<std::size_t>(Font::glyphs_per_page * Font::max_pages));
+  bool is_parsed {false};
+  if (is_bdf) {
+    is_parsed = font.parse_bdf();
+  } else if (bytes.substr(0, psf1_magic.size()) == psf1_magic) {
+    is_parsed = font.parse_psf1();
+  } else if (bytes.substr(0, psf2_magic.size()) == psf2_magic) {
+    is_parsed = font.parse_psf2();
+  } else {
+    SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
+        "'%s' is not a PSF nor a BDF font\n", file_path.c_str());
+    return {};
+  }
+  if (!is_parsed) {
+    return {};
+  }
+  if (font.m_page_count == 0) {
+    SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
+        "The font '%s' has none of the characters that can be shown\n",
+        file_path.c_str());
+    return {};
+  }
+  return font;
+}
+
+bool Console_font::malformed() const
+{
+  SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
+      "The font file '%s' is malformed\n", m_file_path.c_str());
+  return false;
+}
+
+bool Console_font::set_glyph_size(int width, int height)
+{
+  if (width <= 0 || height <= 0 || width > max_glyph_size ||
+      height > max_glyph_size) {
+    SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
+        "The glyphs of the font '%s' are %dx%d pixels, which is not "
+        "supported (the most is %dx%d)\n",
+        m_file_path.c_str(), width, height, max_glyph_size, max_glyph_size);
+    return false;
+  }
+  m_glyph_size = Size {width, height};
+  return true;
+}
+
+void Console_font::add_glyph(char32_t code_point, const Glyph_bits& glyph)
+{
+  if (code_point == Utf8_decoder::replacement_char) {
+    if (!m_replacement_glyph) {
+      m_replacement_glyph = glyph;
+    }
+    return;
+  }
+  auto slot = slot_of(code_point);
+  // If several glyphs are for the same character, the first one wins:
+  if (slot && !m_glyphs[*slot]) {
+    m_glyphs[*slot] = glyph;
+    m_page_count = std::max(m_page_count,
+        static_cast<int>(*slot / Font::glyphs_per_page) + 1);
+  }
+}
+
+bool Console_font::parse_psf1()
+{
+  const auto bytes = m_file->bytes();
+  if (bytes.size() < psf1_header_size) {
+    return malformed();
+  }
+  const auto mode = static_cast<unsigned char>(bytes[2]);
+  const int height = static_cast<unsigned char>(bytes[3]);
+  if (!set_glyph_size(psf1_glyph_width, height)) {
+    return false;
+  }
+  const int glyph_count =
+      (mode & psf1_mode_512) != 0 ? 2 * psf1_glyph_count : psf1_glyph_count;
+  const auto glyph_size = static_cast<std::size_t>(height);
+  const auto table_start = psf1_header_size + glyph_count * glyph_size;
+  if (bytes.size() < table_start) {
+    return malformed();
+  }
+  auto glyph_bits = [&](int glyph) {
+    return Glyph_bits {
+        bytes.substr(psf1_header_size + glyph * glyph_size, glyph_size),
+        SDL_Rect {0, 0, psf1_glyph_width, height}};
+  };
+  if ((mode & psf1_mode_has_table) == 0) {
+    // Taken to be Latin-1 (or ASCII, at least):
+    for (int glyph = 0; glyph < glyph_count; glyph++) {
+      add_glyph(static_cast<char32_t>(glyph), glyph_bits(glyph));
+    }
+    return true;
+  }
+  // Each glyph has a list of the characters it is for, followed by
+  // sequences of characters (which are of no use here), each entry being two
+  // bytes.
+  int glyph {0};
+  bool is_in_sequence {false};
+  for (auto offset = table_start;
+       offset + 2 <= bytes.size() && glyph < glyph_count; offset += 2) {
+    const auto value = read_le(bytes, offset, 2);
+    if (value == psf1_glyph_end) {
+      glyph++;
+      is_in_sequence = false;
+    } else if (value == psf1_sequence_start) {
+      is_in_sequence = true;
+    } else if (!is_in_sequence) {
+      add_glyph(static_cast<char32_t>(value), glyph_bits(glyph));
+    }
+  }
+  return true;
+}
+
+bool Console_font::parse_psf2()
+{
+  const auto bytes = m_file->bytes();
+  if (bytes.size() < psf2_header_size) {
+    return malformed();
+  }
+  constexpr int field_size {4};
+  const std::size_t header_size =
+      read_le(bytes, psf2_header_size_offset, field_size);
+  const auto flags = read_le(bytes, psf2_flags_offset, field_size);
+  const std::size_t glyph_count =
+      read_le(bytes, psf2_length_offset, field_size);
+  const std::size_t glyph_size =
+      read_le(bytes, psf2_charsize_offset, field_size);
+  const auto height =
+      static_cast<int>(read_le(bytes, psf2_height_offset, field_size));
+  const auto width =
+      static_cast<int>(read_le(bytes, psf2_width_offset, field_size));
+  if (!set_glyph_size(width, height)) {
+    return false;
+  }
+  const auto bytes_per_row =
+      static_cast<std::size_t>((width + CHAR_BIT - 1) / CHAR_BIT);
+  if (header_size < psf2_header_size || header_size > bytes.size() ||
+      glyph_size < bytes_per_row * height ||
+      glyph_count > (bytes.size() - header_size) / glyph_size) {
+    return malformed();
+  }
+  auto glyph_bits = [&](std::size_t glyph) {
+    return Glyph_bits {bytes.substr(header_size + glyph * glyph_size,
+                           bytes_per_row * height),
+        SDL_Rect {0, 0, width, height}};
+  };
+  if ((flags & psf2_flag_has_table) == 0) {
+    for (std::size_t glyph = 0; glyph < glyph_count; glyph++) {
+      add_glyph(static_cast<char32_t>(glyph), glyph_bits(glyph));
+    }
+    return true;
+  }
+  // The same as for PSF1, except that the characters are UTF-8 and the
+  // entries are one byte:
+  std::size_t glyph {0};
+  bool is_in_sequence {false};
+  Utf8_decoder decoder {};
+  for (auto offset = header_size + glyph_count * glyph_size;
+       offset < bytes.size() && glyph < glyph_count; offset++) {
+    const auto value = static_cast<unsigned char>(bytes[offset]);
+    if (value == psf2_glyph_end) {
+      glyph++;
+      is_in_sequence = false;
+      decoder.reset();
+    } else if (value == psf2_sequence_start) {
+      is_in_sequence = true;
+      decoder.reset();
+    } else {
+      std::optional<char32_t> code_point {value};
+      if (value >= top_bit_of_byte) {
+        code_point = decoder.feed(bytes[offset]);
+      } else {
+        decoder.reset();
+      }
+      if (code_point && !is_in_sequence) {
+        add_glyph(*code_point, glyph_bits(glyph));
+      }
+    }
+  }
+  return true;
+}
+
+bool Console_font::parse_bdf()
+{
+  auto text = m_file->bytes();
+  int ascent {0};
+  int x_offset {0};
+  bool has_size {false};
+  std::optional<int> encoding {};
+  Glyph_bits glyph {};
+  while (!text.empty()) {
+    auto line = next_line(&text);
+    auto keyword = next_word(&line);
+    if (keyword == "FONTBOUNDINGBOX") {
+      auto width = next_int(&line);
+      auto height = next_int(&line);
+      auto font_x_offset = next_int(&line);
+      auto font_y_offset = next_int(&line);
+      if (!width || !height || !font_x_offset || !font_y_offset) {
+        return malformed();
+      }
+      if (!set_glyph_size(*width, *height)) {
+        return false;
+      }
+      // The glyphs are placed relative to the baseline:
+      ascent = *height + *font_y_offset;
+      x_offset = *font_x_offset;
+      has_size = true;
+    } else if (keyword == "STARTCHAR") {
+      if (!has_size) {
+        return malformed();
+      }
+      encoding.reset();
+      glyph = Glyph_bits {};
+    } else if (keyword == "ENCODING") {
+      // Taken to be Unicode (which Latin-1 is the start of). Any glyph
+      // without a standard encoding has -1 here.
+      encoding = next_int(&line);
+    } else if (keyword == "BBX") {
+      auto width = next_int(&line);
+      auto height = next_int(&line);
+      auto glyph_x_offset = next_int(&line);
+      auto glyph_y_offset = next_int(&line);
+      if (!width || !height || !glyph_x_offset || !glyph_y_offset ||
+          *width < 0 || *height < 0 || *width > max_glyph_size ||
+          *height > max_glyph_size) {
+        return malformed();
+      }
+      glyph.area = SDL_Rect {*glyph_x_offset - x_offset,
+          ascent - (*glyph_y_offset + *height), *width, *height};
+    } else if (keyword == "BITMAP") {
+      // The bits are the lines up to ENDCHAR:
+      const auto* start = text.data();
+      bool has_end {false};
+      while (!text.empty() && !has_end) {
+        const auto* line_start = text.data();
+        auto bitmap_line = next_line(&text);
+        if (next_word(&bitmap_line) == "ENDCHAR") {
+          glyph.bits = std::string_view {
+              start, static_cast<std::size_t>(line_start - start)};
+          has_end = true;
+        }
+      }
+      if (!has_end) {
+        return malformed();
+      }
+      if (encoding && *encoding >= 0) {
+        add_glyph(static_cast<char32_t>(*encoding), glyph);
+      }
+    }
+  }
+  if (!has_size) {
+    return malformed();
+  }
+  return true;
+}
+
+Surface_loader Console_font::start_building_bitmap() &&
+{
+  auto file_path = m_file_path;
+  // Shared, so that the glyphs do not get copied along with the function
+  // that builds the bitmap:
+  return Surface_loader::start(
+      [font = std::make_shared<const Console_font>(std::move(*this))]() {
+        return font->build_bitmap();
+      },
+      std::move(file_path));
+}
+
+SDL_Surface* Console_font::build_bitmap() const
+{
+  const int width = Font::bitmap_char_per_line * m_glyph_size.width;
+  const int page_height =
+      2 * Font::bitmap_lines_per_mode * m_glyph_size.height;
+  auto* bitmap = SDL_CreateRGBSurfaceWithFormat(0, width,
+      m_page_count * page_height, bytes_per_pixel * CHAR_BIT,
+      SDL_PIXELFORMAT_RGB24);
+  if (bitmap == nullptr) {
+    SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
+        "Could not make the font bitmap of '%s': %s\n", m_file_path.c_str(),
+        ::SDL_GetError());
+    return nullptr;
+  }
+  SDL_FillRect(bitmap, nullptr, SDL_MapRGB(bitmap->format, 0, 0, 0));
+  for (int page = 0; page < m_page_count; page++) {
+    SDL_Rect inversed_half {0,
+        page * page_height + page_height / 2, width, page_height / 2};
+    SDL_FillRect(bitmap, &inversed_half,
+        SDL_MapRGB(bitmap->format, max_intensity, max_intensity,
+            max_intensity));
+  }
+  const auto& fallback = m_replacement_glyph
+                             ? m_replacement_glyph
+                             : m_glyphs[static_cast<std::size_t>('?')];
+  const auto& block = m_glyphs[*slot_of(full_block)];
+  const int glyph_count = m_page_count * Font::glyphs_per_page;
+  for (int index = 0; index < glyph_count; index++) {
+    const auto glyph = static_cast<Glyph>(index);
+    auto source = m_glyphs[glyph];
+    if (glyph == cursor_glyph) {
+      source = block;
+      if (!source) {
+        // The font has no full block, so it is just filled in:
+        SDL_Rect square {0, 0, m_glyph_size.width, m_glyph_size.height};
+        SDL_FillRect(bitmap, &square,
+            SDL_MapRGB(bitmap->format, max_intensity, max_intensity,
+                max_intensity));
+        square.y += page_height / 2;
+        SDL_FillRect(bitmap, &square, SDL_MapRGB(bitmap->format, 0, 0, 0));
+        continue;
+      }
+    }
+    // Control characters never get shown, so they are left empty:
+    if (glyph == not_in_font_glyph ||
+        (!source && !is_control(Font::code_point_of(glyph)))) {
+      source = fallback;
+    }
+    if (!source) {
+      continue;
+    }
+    const int page = index / Font::glyphs_per_page;
+    const int place = index % Font::glyphs_per_page;
+    SDL_Point square {
+        (place % Font::bitmap_char_per_line) * m_glyph_size.width,
+        page * page_height +
+            (place / Font::bitmap_char_per_line) * m_glyph_size.height};
+    draw_glyph(*source, bitmap, square, false);
+    square.y += page_height / 2;
+    draw_glyph(*source, bitmap, square, true);
+  }
+  return bitmap;
+}
+
+void Console_font::draw_glyph(const Glyph_bits& glyph, SDL_Surface* bitmap,
+    const SDL_Point& square, bool is_inversed) const
+{
+  const Uint8 intensity = is_inversed ? 0 : max_intensity;
+  auto* pixels = static_cast<Uint8*>(bitmap->pixels);
+  auto bits = glyph.bits;
+  const auto bytes_per_row =
+      static_cast<std::size_t>((glyph.area.w + CHAR_BIT - 1) / CHAR_BIT);
+  for (int row = 0; row < glyph.area.h && !bits.empty(); row++) {
+    std::string_view row_bits {};
+    if (m_format == Format::psf) {
+      row_bits = bits.substr(0, bytes_per_row);
+      bits.remove_prefix(row_bits.size());
+    } else {
+      auto line = next_line(&bits);
+      row_bits = next_word(&line);
+    }
+    const int y = glyph.area.y + row;
+    if (y < 0 || y >= m_glyph_size.height) {
+      continue;
+    }
+    for (int column = 0; column < glyph.area.w; column++) {
+      const int x = glyph.area.x + column;
+      if (x < 0 || x >= m_glyph_size.width) {
+        continue;
+      }
+      bool is_set {false};
+      if (m_format == Format::psf) {
+        const auto byte = static_cast<std::size_t>(column / CHAR_BIT);
+        is_set = byte < row_bits.size() &&
+                 (static_cast<unsigned char>(row_bits[byte]) &
+                     (top_bit_of_byte >> (column % CHAR_BIT))) != 0;
+      } else {
+        const auto digit =
+            static_cast<std::size_t>(column / bits_per_hex_digit);
+        auto value = digit < row_bits.size() ? hex_digit(row_bits[digit])
+                                             : std::nullopt;
+        is_set = value && (*value & (top_bit_of_hex_digit >>
+                                        (column % bits_per_hex_digit))) != 0;
+      }
+      if (is_set) {
+        auto* pixel = pixels + (square.y + y) * bitmap->pitch +
+                      (square.x + x) * bytes_per_pixel;
+        std::fill(pixel, pixel + bytes_per_pixel, intensity);
+      }
+    }
+  }
+}
+} // namespace remotemo
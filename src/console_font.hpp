@@ -0,0 +1,66 @@
+#ifndef REMOTEMO_SRC_CONSOLE_FONT_HPP
+#define REMOTEMO_SRC_CONSOLE_FONT_HPP
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "remotemo/common_types.hpp"
+#include "mapped_file.hpp"
+#include "texture.hpp"
+#include <SDL.h>
+
+namespace remotemo {
+// A Linux console font (PSF, version 1 or 2) or a BDF font, read straight
+// from the mapped file. Only the glyphs that have a place in the pages of
+// the font bitmap (see Font) get looked up when parsing, and their bits only
+// get decoded when building the bitmap.
+class Console_font {
+public:
+  static std::optional<Console_font> create(const std::string& file_path);
+
+  [[nodiscard]] const Size& glyph_size() const { return m_glyph_size; }
+  // Builds the font bitmap, in the layout Font expects, on a worker thread.
+  // The parsed font gets moved to that thread.
+  [[nodiscard]] Surface_loader start_building_bitmap() &&;
+
+private:
+  enum class Format { psf, bdf };
+  struct Glyph_bits {
+    // PSF: the rows of the glyph, each a whole number of bytes. BDF: the
+    // lines of hex digits between BITMAP and ENDCHAR.
+    std::string_view bits {};
+    // Where the glyph goes within its square (a BDF glyph can be smaller):
+    SDL_Rect area {0, 0, 0, 0};
+  };
+
+  Console_font(std::shared_ptr<const Mapped_file> file, std::string file_path,
+      Format format)
+      : m_file(std::move(file)), m_file_path(std::move(file_path)),
+        m_format(format)
+  {}
+  bool parse_psf1();
+  bool parse_psf2();
+  bool parse_bdf();
+  // Returns false if the glyph size is not supported.
+  bool set_glyph_size(int width, int height);
+  bool malformed() const;
+  void add_glyph(char32_t code_point, const Glyph_bits& glyph);
+  [[nodiscard]] SDL_Surface* build_bitmap() const;
+  void draw_glyph(const Glyph_bits& glyph, SDL_Surface* bitmap,
+      const SDL_Point& square, bool is_inversed) const;
+
+  // Keeps the bits of the glyphs around for as long as they are needed:
+  std::shared_ptr<const Mapped_file> m_file;
+  std::string m_file_path;
+  Format m_format;
+  Size m_glyph_size {0, 0};
+  // Indexed by the glyphs of the font bitmap:
+  std::vector<std::optional<Glyph_bits>> m_glyphs {};
+  std::optional<Glyph_bits> m_replacement_glyph {};
+  int m_page_count {0};
+};
+} // namespace remotemo
+#endif // REMOTEMO_SRC_CONSOLE_FONT_HPP
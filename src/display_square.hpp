@@ -0,0 +1,16 @@
+#ifndef REMOTEMO_SRC_DISPLAY_SQUARE_HPP
+#define REMOTEMO_SRC_DISPLAY_SQUARE_HPP
+
+#include <cstdint>
+
+namespace remotemo {
+// Index of a glyph in the font bitmap. For ASCII characters it is the same
+// as the character (see Font::glyph_of() for the rest).
+using Glyph = std::uint16_t;
+
+struct Display_square {
+  Glyph glyph {' '};
+  bool is_inversed {false};
+};
+} // namespace remotemo
+#endif // REMOTEMO_SRC_DISPLAY_SQUARE_HPP
@@ -0,0 +1,28 @@
+#include "embedded_res.hpp"
+
+#include <filesystem>
+
+namespace remotemo {
+#ifdef REMOTEMO_EMBED_RESOURCES
+// Defined in the source file generated by cmake/embed_resources.cmake
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays)
+extern const Embedded_res embedded_res_table[];
+extern const std::size_t embedded_res_count;
+#endif
+
+std::optional<Embedded_res> Embedded_res::find(
+    [[maybe_unused]] const std::string& file_path)
+{
+#ifdef REMOTEMO_EMBED_RESOURCES
+  auto path = std::filesystem::path(file_path).lexically_normal();
+  for (std::size_t i = 0; i < embedded_res_count; i++) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const auto& embedded = embedded_res_table[i];
+    if (path == std::filesystem::path(embedded.file_path)) {
+      return embedded;
+    }
+  }
+#endif
+  return {};
+}
+} // namespace remotemo
@@ -0,0 +1,21 @@
+#ifndef REMOTEMO_SRC_EMBEDDED_RES_HPP
+#define REMOTEMO_SRC_EMBEDDED_RES_HPP
+
+#include <cstddef>
+#include <string>
+#include <optional>
+
+namespace remotemo {
+// A resource file that has been compiled into the library (see the
+// REMOTEMO_EMBED_RESOURCES option in CMakeLists.txt).
+struct Embedded_res {
+  const char* file_path;
+  const unsigned char* data;
+  std::size_t size;
+
+  // Returns the embedded resource that was compiled from the file with the
+  // given (relative) path, if any.
+  static std::optional<Embedded_res> find(const std::string& file_path);
+};
+} // namespace remotemo
+#endif // REMOTEMO_SRC_EMBEDDED_RES_HPP
@@ -1,12 +1,38 @@
 #include "engine.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <vector>
 
 #include "font.hpp"
+#include "console_font.hpp"
 #include "keyboard.hpp"
+#include "stopwatch.hpp"
+#include "text_scan.hpp"
 
 namespace remotemo {
+namespace {
+// Marks the engine as busy for as long as it exists (restoring the previous
+// state afterwards, so that it can be nested).
+class Busy_guard {
+public:
+  explicit Busy_guard(bool* is_busy) noexcept
+      : m_is_busy(is_busy), m_was_busy(*is_busy)
+  {
+    *m_is_busy = true;
+  }
+  ~Busy_guard() { *m_is_busy = m_was_busy; }
+  Busy_guard(Busy_guard&&) = delete;
+  Busy_guard& operator=(Busy_guard&&) = delete;
+  Busy_guard(const Busy_guard&) = delete;
+  Busy_guard& operator=(const Busy_guard&) = delete;
+
+private:
+  bool* m_is_busy;
+  bool m_was_busy;
+};
+} // namespace
+
 Main_SDL_handler::~Main_SDL_handler()
 {
   if (m_do_sdl_quit) {
@@ -80,9 +106,15 @@ Engine::Engine(Main_SDL_handler main_sdl_handler,
       m_key_fullscreen(config.m_key_fullscreen),
       m_key_close_window(config.m_key_close_window),
       m_key_quit(config.m_key_quit),
+      m_key_scroll_back(config.m_key_scroll_back),
+      m_key_scroll_forward(config.m_key_scroll_forward),
+      m_key_skip_animation(config.m_key_skip_animation),
       m_is_closing_same_as_quit(config.m_is_closing_same_as_quit),
       m_pre_close_function(config.m_pre_close_function),
-      m_pre_quit_function(config.m_pre_quit_function)
+      m_pre_quit_function(config.m_pre_quit_function),
+      m_scaling_mode(config.m_scaling_mode),
+      m_command_queue(std::make_shared<Command_queue>()),
+      m_clock(config.m_clock_mode)
 {
   set_screen_display_settings();
 }
@@ -107,6 +139,10 @@ void Engine::refresh_screen_display_settings()
   float scale_h = static_cast<float>(window_size.height) /
                   static_cast<float>(backgr_min_area.height);
   m_screen_scale = std::min(scale_w, scale_h);
+  if (m_scaling_mode == Scaling_mode::integer) {
+    // If the window is too small for the min_area, then it gets clipped:
+    m_screen_scale = std::max(1.0f, std::floor(m_screen_scale));
+  }
   m_background_target.x =
       ((static_cast<int>(
             static_cast<float>(window_size.width) / m_screen_scale) -
@@ -124,6 +160,94 @@ void Engine::refresh_screen_display_settings()
       backgr_text_area.x + static_cast<float>(m_background_target.x);
   m_text_target.y =
       backgr_text_area.y + static_cast<float>(m_background_target.y);
+  if (m_scaling_mode == Scaling_mode::integer) {
+    snap_text_target();
+  }
+  // Rebuilt (before the next frame gets rendered) to match the new settings:
+  m_is_composite_outdated = true;
+}
+
+void Engine::snap_text_target()
+{
+  // The text gets scaled by its own whole number, as big as fits within the
+  // text area, and centered within it. Everything in window pixels:
+  const auto& text_size = m_text_display->texture_size();
+  const float area_w = m_text_target.w * m_screen_scale;
+  const float area_h = m_text_target.h * m_screen_scale;
+  const float text_scale = std::max(1.0f,
+      std::floor(std::min(area_w / static_cast<float>(text_size.width),
+          area_h / static_cast<float>(text_size.height))));
+  const float text_w = static_cast<float>(text_size.width) * text_scale;
+  const float text_h = static_cast<float>(text_size.height) * text_scale;
+  const float x =
+      std::round(m_text_target.x * m_screen_scale + (area_w - text_w) / 2);
+  const float y =
+      std::round(m_text_target.y * m_screen_scale + (area_h - text_h) / 2);
+  m_text_target = SDL_FRect {x / m_screen_scale, y / m_screen_scale,
+      text_w / m_screen_scale, text_h / m_screen_scale};
+}
+
+SDL_ScaleMode Engine::scale_mode() const
+{
+  return m_scaling_mode == Scaling_mode::integer ? SDL_ScaleModeNearest
+                                                 : SDL_ScaleModeLinear;
+}
+
+void Engine::apply_scale_mode()
+{
+  m_text_display->scale_mode(scale_mode());
+}
+
+void Engine::render_background()
+{
+  // The background might have been handed over in the config, so its scale
+  // mode only gets changed for as long as it takes to draw it:
+  auto* renderer = m_renderer->res();
+  auto* background = m_background->res();
+  SDL_ScaleMode previous_mode {SDL_ScaleModeLinear};
+  ::SDL_GetTextureScaleMode(background, &previous_mode);
+  ::SDL_SetTextureScaleMode(background, scale_mode());
+  ::SDL_RenderSetScale(renderer, m_screen_scale, m_screen_scale);
+  ::SDL_RenderCopy(renderer, background, nullptr, &m_background_target);
+  // Drawn before the scale mode gets changed back:
+  ::SDL_RenderFlush(renderer);
+  ::SDL_SetTextureScaleMode(background, previous_mode);
+}
+
+bool Engine::rebuild_composite()
+{
+  auto* renderer = m_renderer->res();
+  auto window_size = m_window->size();
+  auto create_target = [renderer, &window_size]() {
+    auto* texture = ::SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32,
+        SDL_TEXTUREACCESS_TARGET, window_size.width, window_size.height);
+    if (texture != nullptr) {
+      // They only ever get copied 1:1 and replace what is underneath:
+      ::SDL_SetTextureScaleMode(texture, SDL_ScaleModeNearest);
+      ::SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+    }
+    return Res_handler<SDL_Texture> {texture};
+  };
+  m_scaled_background = create_target();
+  m_composed_frame = create_target();
+  if (m_scaled_background.res() == nullptr ||
+      m_composed_frame.res() == nullptr) {
+    ::SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+        "Could not create the textures for caching the scaled background, "
+        "so it will get scaled every frame: %s\n",
+        ::SDL_GetError());
+    m_scaled_background = Res_handler<SDL_Texture> {};
+    m_composed_frame = Res_handler<SDL_Texture> {};
+    return false;
+  }
+  ::SDL_SetRenderTarget(renderer, m_scaled_background.res());
+  ::SDL_RenderClear(renderer);
+  render_background();
+  ::SDL_RenderSetScale(renderer, 1.0f, 1.0f);
+  ::SDL_SetRenderTarget(renderer, nullptr);
+  m_stats.render_copy_calls++;
+  m_stats.render_target_switches += 2;
+  return true;
 }
 
 std::unique_ptr<Engine> Engine::create(const Config& config)
@@ -150,41 +274,115 @@ std::unique_ptr<Engine> Engine::create(const Config& config)
   Res_handler<SDL_Texture> font_texture {
       config.font().raw_sdl, config.cleanup_all()};
 
+  // Only measured if asked for:
+  std::optional<Stopwatch> stopwatch {};
+  Startup_timings timings {};
+  // A phase can be ended more than once, adding up the time spent in it:
+  auto end_of_phase = [&stopwatch](double* phase_ms) {
+    if (stopwatch) {
+      *phase_ms += stopwatch->lap_ms();
+    }
+  };
+  if (config.startup_timing() != Startup_timing_mode::off) {
+    stopwatch.emplace();
+  }
+
   if (!config.validate(renderer_from_conf.res())) {
     return nullptr;
   }
+  std::unique_ptr<Frame_capture> frame_capture {};
+  if (config.capture_format() != Capture_format::none) {
+    frame_capture = Frame_capture::create(
+        config.capture_path_prefix(), config.capture_format());
+    if (!frame_capture) {
+      return nullptr;
+    }
+  }
+  std::optional<Session_recorder> recorder {};
+  if (!config.record_session_file().empty()) {
+    recorder = Session_recorder::create(config.record_session_file());
+    if (!recorder) {
+      return nullptr;
+    }
+  }
+  end_of_phase(&timings.preparation_ms);
   if (!main_sdl_handler.setup(sdl_init_flags)) {
     return nullptr;
   }
+  end_of_phase(&timings.sdl_init_ms);
+  // A console font is parsed here (it is mapped, not read), so that the
+  // size of its characters is known, but its bitmap gets built along with
+  // the decoding of the images.
+  auto font_config = config.font();
+  std::optional<Console_font> console_font {};
+  if (font_config.raw_sdl == nullptr && !font_config.psf_file_path.empty()) {
+    console_font = Console_font::create(font_config.psf_file_path);
+    if (!console_font) {
+      return nullptr;
+    }
+    font_config.width = console_font->glyph_size().width;
+    font_config.height = console_font->glyph_size().height;
+  }
+  // The images get decoded on worker threads while the window and renderer
+  // are being created. Only the textures have to wait for the renderer.
+  auto font_surface = console_font
+                          ? std::move(*console_font).start_building_bitmap()
+                          : Texture::start_loading(font_config);
+  auto backgr_surface = Texture::start_loading(config.background());
+  end_of_phase(&timings.preparation_ms);
   window = Window::create(config.window(), std::move(window_from_conf));
   if (!window) {
     return nullptr;
   }
-  renderer = Renderer::create(window->res(), std::move(renderer_from_conf));
+  end_of_phase(&timings.window_ms);
+  renderer = Renderer::create(
+      window->res(), std::move(renderer_from_conf), config.renderer());
   if (!renderer) {
     return nullptr;
   }
-  auto font =
-      Font::create(config.font(), std::move(font_texture), renderer->res());
+  end_of_phase(&timings.renderer_ms);
+  auto font = Font::create(font_config, std::move(font_texture),
+      std::move(font_surface), renderer->res());
   if (!font) {
     return nullptr;
   }
-  auto background = Background::create(
-      config.background(), std::move(backgr_texture), renderer->res());
+  end_of_phase(&timings.font_ms);
+  auto background = Background::create(config.background(),
+      std::move(backgr_texture), std::move(backgr_surface), renderer->res());
   if (!background) {
     return nullptr;
   }
+  end_of_phase(&timings.background_ms);
   auto text_display = Text_display::create(
       std::move(*font), config.text_area(), renderer->res());
   if (!text_display) {
     return nullptr;
   }
-  return std::make_unique<Engine>(std::move(main_sdl_handler),
+  end_of_phase(&timings.text_area_ms);
+  auto engine = std::make_unique<Engine>(std::move(main_sdl_handler),
       std::move(window), std::move(renderer), std::move(background),
       std::move(text_display), config);
+  engine->m_recorder = std::move(recorder);
+  engine->m_frame_capture = std::move(frame_capture);
+  if (stopwatch) {
+    timings.create_ms = stopwatch->total_ms();
+    engine->m_startup_timings = timings;
+    engine->m_startup_counter = stopwatch->start();
+    engine->m_do_log_startup_timings =
+        (config.startup_timing() == Startup_timing_mode::measure_and_log);
+    if (engine->m_do_log_startup_timings) {
+      ::SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+          "Startup timings (ms): preparation: %.3f, SDL_Init: %.3f, "
+          "window: %.3f, renderer: %.3f, font: %.3f, background: %.3f, "
+          "text area: %.3f, total create(): %.3f\n",
+          timings.preparation_ms, timings.sdl_init_ms, timings.window_ms,
+          timings.renderer_ms, timings.font_ms, timings.background_ms,
+          timings.text_area_ms, timings.create_ms);
+    }
+  }
+  return engine;
 }
 
-
 Point Engine::cursor_pos() const
 {
   throw_if_window_closed();
@@ -203,27 +401,129 @@ char Engine::char_at(const Point& pos) const
   return m_text_display->char_at(pos);
 }
 
+char32_t Engine::code_point_at(const Point& pos) const
+{
+  throw_if_window_closed();
+  return m_text_display->code_point_at(pos);
+}
+
 bool Engine::is_inverse_at(const Point& pos) const
 {
   throw_if_window_closed();
   return m_text_display->is_inverse_at(pos);
 }
 
-bool Engine::display_string_at_cursor(
-    const std::string& text, Wrapping text_wrapping)
+bool Engine::display_string_at_cursor(const std::string& text)
+{
+  throw_if_window_closed();
+  Busy_guard busy_guard {&m_is_busy};
+  Busy_guard printing_guard {&m_is_printing};
+  // Only a request made while this is printing counts:
+  m_command_queue->take_skip_request();
+  auto result = put_string_at_cursor(text);
+  if (m_is_skipping) {
+    m_is_skipping = false;
+    // The rest of the text went out at once, so it gets rendered at once:
+    main_loop_once();
+  }
+  return result;
+}
+
+bool Engine::display_stream(std::istream& input)
 {
   throw_if_window_closed();
+  Busy_guard busy_guard {&m_is_busy};
+  Busy_guard printing_guard {&m_is_printing};
+  m_command_queue->take_skip_request();
+  // Allocated once, so the memory used does not depend on the size of the
+  // input (the scrollback, if any, being bounded as well):
+  std::string chunk(stream_chunk_size, '\0');
+  bool is_all_displayed = true;
+  while (is_all_displayed && input) {
+    input.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    const auto length = static_cast<std::size_t>(input.gcount());
+    if (length == 0) {
+      break;
+    }
+    const std::string_view text {chunk.data(), length};
+    if (m_recorder) {
+      record(Trace_event {Trace_event::Type::print, 0, std::string {text}});
+    }
+    if (m_delay_between_chars_ms == 0) {
+      // Nothing to animate, so only the screen as it ends up gets rendered:
+      m_is_skipping = true;
+    }
+    is_all_displayed = put_string_at_cursor(text);
+    // Still handling the events (e.g. the window getting closed) in between
+    // the chunks, even when not rendering:
+    SDL_Event event;
+    while (SDL_PollEvent(&event) != 0) {
+      handle_standard_event(event);
+    }
+    throw_if_window_closed();
+  }
+  m_is_skipping = false;
+  main_loop_once();
+  return is_all_displayed;
+}
+
+bool Engine::put_string_at_cursor(std::string_view text)
+{
   auto cursor_pos = m_text_display->cursor_pos();
-  for (const auto character : text) {
+  for (std::size_t index = 0; index < text.size(); index++) {
+    const auto character = text[index];
+    if (m_is_parsing_escapes) {
+      auto result = m_escape_parser.feed(character);
+      if (result == Escape_parser::Result::none) {
+        continue;
+      }
+      if (result == Escape_parser::Result::sequence) {
+        run_escape_sequence(&cursor_pos);
+        if (!m_is_skipping) {
+          main_loop_once();
+        }
+        continue;
+      }
+      if (character == '\r') {
+        cursor_pos.x = 0;
+        m_text_display->cursor_pos(cursor_pos);
+        continue;
+      }
+    }
+    auto code_point = static_cast<char32_t>(character);
+    if (static_cast<signed char>(character) < 0) {
+      // Part of a UTF-8 sequence, which only takes up the one square once
+      // it is complete:
+      auto decoded = m_utf8_decoder.feed(character);
+      if (!decoded) {
+        continue;
+      }
+      code_point = *decoded;
+    } else if (m_utf8_decoder.is_in_sequence()) {
+      // Cut short, so dropped.
+      m_utf8_decoder.reset();
+    }
     if (!scroll_if_needed(&cursor_pos)) {
       return false;
     }
-    delay(m_delay_between_chars_ms);
+    // When nothing gets rendered in between the characters, those that
+    // would just be put one after the other get put all at once:
+    if (m_is_skipping &&
+        (!m_is_parsing_escapes || m_escape_parser.is_idle())) {
+      auto run_length = put_printable_run(text.substr(index), &cursor_pos);
+      if (run_length > 0) {
+        index += run_length - 1;
+        continue;
+      }
+    }
+    if (!is_skipping()) {
+      delay(m_delay_between_chars_ms);
+    }
     switch (character) {
 
       case '\n': // New line
         cursor_pos.x = 0;
-        cursor_pos.y++;
+        line_feed(&cursor_pos);
         m_text_display->cursor_pos(cursor_pos);
         break;
 
@@ -240,42 +540,88 @@ bool Engine::display_string_at_cursor(
         if (cursor_pos.x == m_text_display->columns()) {
           // This can happen if wrapping was off the last time the cursor
           // moved. But wrap might have been set to on since then.
-          if (text_wrapping == Wrapping::off) {
+          if (m_text_wrapping == Wrapping::off) {
             // If wrapping is off, the cursor is allowed to go off the screen
             // but nothing can be displayed there.
             return false;
           }
           cursor_pos.x = 0;
-          cursor_pos.y++;
+          line_feed(&cursor_pos);
           m_text_display->cursor_pos(cursor_pos);
           if (!scroll_if_needed(&cursor_pos)) {
             return false;
           }
         }
-        m_text_display->set_char_at_cursor(character);
+        m_text_display->set_char_at_cursor(code_point);
         cursor_pos.x++;
         if (cursor_pos.x == m_text_display->columns() &&
-            text_wrapping != Wrapping::off) {
+            m_text_wrapping != Wrapping::off) {
           // If wrapping is off, the cursor is allowed to go off the screen
           cursor_pos.x = 0;
-          cursor_pos.y++;
+          line_feed(&cursor_pos);
         }
         m_text_display->cursor_pos(cursor_pos);
         break;
     }
-    main_loop_once();
+    if (!m_is_skipping) {
+      main_loop_once();
+    }
   }
   return true;
 }
 
-void Engine::clear_screen()
+void Engine::clear_screen(Do_reset do_reset)
 {
+  Busy_guard busy_guard {&m_is_busy};
+  auto old_cursor_pos = cursor_pos();
   auto lines = m_text_display->lines();
   for (int line = 0; line < lines; line++) {
     delay(m_delay_between_chars_ms);
     m_text_display->clear_line(line);
     main_loop_once();
   }
+  if (do_reset == Do_reset::inverse || do_reset == Do_reset::all) {
+    is_output_inversed(false);
+  }
+  if (do_reset == Do_reset::cursor || do_reset == Do_reset::all) {
+    cursor_pos(Point {0, 0});
+  } else {
+    cursor_pos(old_cursor_pos);
+  }
+}
+
+int Engine::scrollback_size() const
+{
+  throw_if_window_closed();
+  return m_text_display->scrollback_size();
+}
+
+int Engine::view_offset() const
+{
+  throw_if_window_closed();
+  return m_text_display->view_offset();
+}
+
+bool Engine::view_offset(int offset)
+{
+  throw_if_window_closed();
+  auto is_within_range = m_text_display->view_offset(offset);
+  main_loop_once();
+  return is_within_range;
+}
+
+Point Engine::view_position() const
+{
+  throw_if_window_closed();
+  return m_text_display->view_position();
+}
+
+bool Engine::view_position(const Point& pos)
+{
+  throw_if_window_closed();
+  auto is_within_range = m_text_display->view_position(pos);
+  main_loop_once();
+  return is_within_range;
 }
 
 bool Engine::scroll_if_needed(Point* cursor_pos)
@@ -284,15 +630,174 @@ bool Engine::scroll_if_needed(Point* cursor_pos)
     return false;
   }
   while (cursor_pos->y >= m_text_display->lines()) {
-    delay(m_delay_between_chars_ms);
+    if (!is_skipping()) {
+      delay(m_delay_between_chars_ms);
+    }
     m_text_display->scroll_up_one_line();
     cursor_pos->y--;
     m_text_display->cursor_pos(*cursor_pos);
-    main_loop_once();
+    if (!m_is_skipping) {
+      main_loop_once();
+    }
   }
   return true;
 }
 
+std::size_t Engine::put_printable_run(
+    std::string_view text, Point* cursor_pos)
+{
+  const int columns = m_text_display->columns();
+  if (cursor_pos->x >= columns) {
+    return 0;
+  }
+  auto length = printable_run_length(
+      text.substr(0, static_cast<std::size_t>(columns - cursor_pos->x)));
+  if (length == 0) {
+    return 0;
+  }
+  m_text_display->set_chars_at_cursor(text.substr(0, length));
+  cursor_pos->x += static_cast<int>(length);
+  if (cursor_pos->x == columns && m_text_wrapping != Wrapping::off) {
+    // If wrapping is off, the cursor is allowed to go off the screen
+    cursor_pos->x = 0;
+    line_feed(cursor_pos);
+  }
+  m_text_display->cursor_pos(*cursor_pos);
+  return length;
+}
+
+void Engine::line_feed(Point* cursor_pos)
+{
+  cursor_pos->y++;
+  if (m_scroll_region && cursor_pos->y == m_scroll_region->second + 1) {
+    m_text_display->scroll_lines_up(
+        m_scroll_region->first, m_scroll_region->second);
+    cursor_pos->y--;
+  }
+}
+
+void Engine::is_parsing_escapes(bool is_parsing_escapes)
+{
+  m_is_parsing_escapes = is_parsing_escapes;
+  m_escape_parser.reset();
+  m_scroll_region.reset();
+}
+
+void Engine::run_escape_sequence(Point* cursor_pos)
+{
+  const auto& parser = m_escape_parser;
+  const int columns = m_text_display->columns();
+  const int lines = m_text_display->lines();
+  const int count = parser.param(0, 1);
+  switch (parser.final_char()) {
+    case 'A': // Cursor up
+      cursor_pos->y = std::max(std::min(cursor_pos->y, lines - 1) - count, 0);
+      break;
+    case 'B': // Cursor down
+      cursor_pos->y = std::min(cursor_pos->y + count, lines - 1);
+      break;
+    case 'C': // Cursor forward
+      cursor_pos->x = std::min(cursor_pos->x + count, columns - 1);
+      break;
+    case 'D': // Cursor back
+      cursor_pos->x =
+          std::max(std::min(cursor_pos->x, columns - 1) - count, 0);
+      break;
+    case 'H': // Cursor position
+    case 'f':
+      cursor_pos->y = std::clamp(parser.param(0, 1) - 1, 0, lines - 1);
+      cursor_pos->x = std::clamp(parser.param(1, 1) - 1, 0, columns - 1);
+      break;
+    case 'J': // Erase in display
+      erase_in_display(parser.param(0, 0), *cursor_pos);
+      break;
+    case 'K': // Erase in line
+      erase_in_line(parser.param(0, 0), *cursor_pos);
+      break;
+    case 'm': // Select graphic rendition (only inverse is supported)
+      for (int i = 0; i < parser.param_count(); i++) {
+        constexpr int sgr_reset {0};
+        constexpr int sgr_inverse {7};
+        constexpr int sgr_not_inverse {27};
+        auto value = parser.param(i, sgr_reset);
+        if (value == sgr_reset || value == sgr_not_inverse) {
+          m_text_display->is_output_inversed(false);
+        } else if (value == sgr_inverse) {
+          m_text_display->is_output_inversed(true);
+        }
+      }
+      break;
+    case 'r': { // Set scroll region
+      auto top = parser.param(0, 1) - 1;
+      auto bottom = parser.param(1, lines) - 1;
+      if (top >= bottom || bottom >= lines) {
+        return;
+      }
+      if (top == 0 && bottom == lines - 1) {
+        m_scroll_region.reset();
+      } else {
+        m_scroll_region = std::pair {top, bottom};
+      }
+      *cursor_pos = Point {0, 0};
+      break;
+    }
+    default:
+      // Not supported, so ignored.
+      return;
+  }
+  m_text_display->cursor_pos(*cursor_pos);
+}
+
+void Engine::erase_in_display(int mode, const Point& cursor_pos)
+{
+  const int lines = m_text_display->lines();
+  // 0: from the cursor to the end, 1: from the start to the cursor, 2: all
+  constexpr int erase_all {2};
+  if (mode < 0 || mode > erase_all) {
+    // E.g. 3, which (in xterm) erases the scrollback.
+    return;
+  }
+  if (mode == erase_all) {
+    for (int line = 0; line < lines; line++) {
+      m_text_display->clear_line(line);
+    }
+    return;
+  }
+  erase_in_line(mode, cursor_pos);
+  const int first_line = mode == 0 ? cursor_pos.y + 1 : 0;
+  const int end_line = mode == 0 ? lines : std::min(cursor_pos.y, lines);
+  for (int line = first_line; line < end_line; line++) {
+    m_text_display->clear_line(line);
+  }
+}
+
+void Engine::erase_in_line(int mode, const Point& cursor_pos)
+{
+  const int columns = m_text_display->columns();
+  if (cursor_pos.y >= m_text_display->lines()) {
+    // The hidden line below the text area has nothing to erase.
+    return;
+  }
+  // 0: from the cursor to the end, 1: from the start to the cursor, 2: all
+  constexpr int erase_all {2};
+  if (mode == erase_all) {
+    m_text_display->clear_line(cursor_pos.y);
+  } else if (mode == 0) {
+    m_text_display->clear_part_of_line(cursor_pos.y, cursor_pos.x, columns);
+  } else if (mode == 1) {
+    m_text_display->clear_part_of_line(
+        cursor_pos.y, 0, std::min(cursor_pos.x + 1, columns));
+  }
+}
+
+bool Engine::is_valid_cursor_pos(const Point& pos) const
+{
+  auto area_size = text_area_size();
+  // NOTE Cursor is allowed to be one line below visible area:
+  return pos.x >= 0 && pos.x < area_size.width && pos.y >= 0 &&
+         pos.y <= area_size.height;
+}
+
 void Engine::cursor_pos(const Point& pos)
 {
   delay(m_delay_between_chars_ms);
@@ -315,21 +820,41 @@ bool Engine::is_output_inversed() const
 void Engine::delay(int delay_in_ms)
 {
   throw_if_window_closed();
+  if (m_clock.is_simulated()) {
+    // The same as when not simulated, no delay means no going through the
+    // main loop (which the caller does anyway), so no extra frame either:
+    if (delay_in_ms <= 0) {
+      return;
+    }
+    // Nothing to wait for, but the window should still get updated (and
+    // the events and queued commands handled) as if it had waited:
+    m_clock.advance(delay_in_ms);
+    m_stats.delay_ms += delay_in_ms;
+    main_loop_once();
+    return;
+  }
+  Stopwatch stopwatch {};
   auto time_now = SDL_GetTicks();
   const auto timeout = time_now + delay_in_ms;
-  while (!SDL_TICKS_PASSED(time_now, timeout)) {
+  // When skipping, the rest of the text being printed goes out at once, so
+  // there is no point waiting any longer:
+  while (!SDL_TICKS_PASSED(time_now, timeout) && !is_skipping()) {
     if (SDL_WaitEventTimeout(nullptr, static_cast<int>(timeout - time_now)) !=
         0) {
       main_loop_once();
     }
     time_now = SDL_GetTicks();
   }
+  m_stats.delay_ms += stopwatch.total_ms();
 }
 
 Key Engine::get_key()
 {
   while (true) {
     throw_if_window_closed();
+    if (run_queued_commands()) {
+      render_window();
+    }
     SDL_Event event;
     if (SDL_WaitEvent(&event) == 0) {
       continue;
@@ -355,6 +880,127 @@ Key Engine::get_key()
   }
 }
 
+void Engine::run(
+    const std::function<bool(const Run_step&)>& update_fn, double step_ms)
+{
+  // When falling further behind than this, the steps get dropped rather than
+  // trying to catch up with them:
+  constexpr int max_catch_up_steps {5};
+  const double start_ms = m_clock.now_ms();
+  double next_step_ms = start_ms;
+  Run_step step {0, step_ms};
+  while (true) {
+    collect_keys(&step.keys);
+    run_queued_commands();
+    auto lag_ms = m_clock.now_ms() - next_step_ms;
+    if (lag_ms < 0.0) {
+      render_window();
+      wait_until(next_step_ms);
+      continue;
+    }
+    if (lag_ms >= max_catch_up_steps * step_ms) {
+      auto dropped_steps =
+          static_cast<Uint64>(lag_ms / step_ms) - (max_catch_up_steps - 1);
+      next_step_ms += static_cast<double>(dropped_steps) * step_ms;
+      lag_ms -= static_cast<double>(dropped_steps) * step_ms;
+      m_stats.steps_dropped += dropped_steps;
+    }
+    Stopwatch stopwatch {};
+    step.elapsed_ms = next_step_ms - start_ms;
+    step.lag_ms = lag_ms;
+    bool do_continue = update_fn(step);
+    m_stats.steps_run++;
+    step.number++;
+    step.keys.clear();
+    next_step_ms += step_ms;
+    // Rendering is left out while catching up:
+    if (!do_continue || m_clock.now_ms() < next_step_ms) {
+      run_queued_commands();
+      render_window();
+    }
+    if (stopwatch.total_ms() > step_ms) {
+      m_stats.steps_overrun++;
+    }
+    if (!do_continue) {
+      return;
+    }
+  }
+}
+
+void Engine::schedule_after(
+    double delay_ms, std::function<void()>&& task_fn)
+{
+  m_scheduler.at(m_clock.now_ms() + delay_ms, std::move(task_fn));
+}
+
+void Engine::schedule_on_key(std::function<void(Key)>&& task_fn)
+{
+  m_scheduler.on_key(std::move(task_fn));
+}
+
+bool Engine::run_scheduled()
+{
+  if (m_is_running_scheduled) {
+    return false;
+  }
+  Busy_guard running_guard {&m_is_running_scheduled};
+  std::vector<Key> keys {};
+  while (!m_scheduler.is_empty()) {
+    collect_keys(&keys);
+    // Keys pressed while nobody is waiting for one are lost, the same way
+    // as when not waiting in get_key():
+    for (auto key : keys) {
+      m_scheduler.key_pressed(key);
+    }
+    keys.clear();
+    run_queued_commands();
+    m_scheduler.run_due(m_clock.now_ms());
+    render_window();
+    if (auto next_time_ms = m_scheduler.next_time_ms()) {
+      wait_until(*next_time_ms);
+    } else if (m_scheduler.is_waiting_for_key()) {
+      ::SDL_WaitEvent(nullptr);
+    }
+  }
+  return true;
+}
+
+void Engine::cancel_scheduled()
+{
+  m_scheduler.clear();
+}
+
+void Engine::collect_keys(std::vector<Key>* keys)
+{
+  throw_if_window_closed();
+  SDL_Event event;
+  while (SDL_PollEvent(&event) != 0) {
+    if (handle_standard_event(event)) {
+      continue;
+    }
+    if (event.type == SDL_KEYDOWN) {
+      auto key = Keyboard::scancode_to_key(event.key.keysym.scancode);
+      if (key) {
+        keys->push_back(*key);
+      }
+    }
+  }
+}
+
+void Engine::wait_until(double time_ms)
+{
+  auto wait_ms = time_ms - m_clock.now_ms();
+  if (wait_ms <= 0.0) {
+    return;
+  }
+  if (m_clock.is_simulated()) {
+    m_clock.advance(wait_ms);
+    return;
+  }
+  // Returns early on any event, which then gets handled before waiting on:
+  ::SDL_WaitEventTimeout(nullptr, static_cast<int>(std::ceil(wait_ms)));
+}
+
 void Engine::main_loop_once()
 {
   throw_if_window_closed();
@@ -362,19 +1008,122 @@ void Engine::main_loop_once()
   while (SDL_PollEvent(&event) != 0) {
     handle_standard_event(event);
   }
+  run_queued_commands();
   render_window();
 }
 
+bool Engine::run_queued_commands()
+{
+  // Queued commands only run in between other operations, never in the
+  // middle of one (e.g. while printing a string):
+  if (m_is_busy) {
+    return false;
+  }
+  m_command_queue->wakeup_handled();
+  bool did_run_any = false;
+  while (auto command = m_command_queue->pop()) {
+    run_command(*command);
+    did_run_any = true;
+  }
+  return did_run_any;
+}
+
+void Engine::run_command(const Command& command)
+{
+  switch (command.type) {
+    case Command::Type::print:
+      record(Trace_event {Trace_event::Type::print, 0, command.text});
+      display_string_at_cursor(command.text);
+      break;
+    case Command::Type::set_cursor:
+      if (is_valid_cursor_pos(command.pos)) {
+        record(
+            Trace_event {Trace_event::Type::set_cursor, 0, {}, command.pos});
+        cursor_pos(command.pos);
+      }
+      break;
+    case Command::Type::set_inverse:
+      record(Trace_event {Trace_event::Type::set_inverse, 0, {}, {0, 0},
+          command.is_inversed ? 1 : 0});
+      is_output_inversed(command.is_inversed);
+      break;
+    case Command::Type::clear:
+      record(Trace_event {Trace_event::Type::clear, 0, {}, {0, 0},
+          static_cast<int>(command.do_reset)});
+      clear_screen(command.do_reset);
+      break;
+  }
+}
+
+void Engine::record(Trace_event&& event)
+{
+  if (m_recorder && !m_is_recording_paused) {
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
+    event.time_us = static_cast<Uint64>(m_clock.now_ms() * 1000.0);
+    m_recorder->record(std::move(event));
+  }
+}
+
 bool Engine::handle_standard_event(const SDL_Event& event)
 {
   if (handle_window_event(event)) {
     return true;
   }
+  if (handle_scrollback_event(event)) {
+    return true;
+  }
+  if (handle_skip_event(event)) {
+    return true;
+  }
   // TODO Add other event handlers? See issue #62
 
   return false;
 }
 
+bool Engine::handle_scrollback_event(const SDL_Event& event)
+{
+  // With no scrollback, the keys are left for the program to get:
+  if (event.type != SDL_KEYDOWN ||
+      m_text_display->scrollback_capacity() == 0) {
+    return false;
+  }
+  // Scrolls a whole page at a time:
+  if (m_key_scroll_back.is_in_event(event)) {
+    m_text_display->view_offset(
+        m_text_display->view_offset() + m_text_display->view_lines());
+    return true;
+  }
+  if (m_key_scroll_forward.is_in_event(event)) {
+    m_text_display->view_offset(
+        m_text_display->view_offset() - m_text_display->view_lines());
+    return true;
+  }
+  return false;
+}
+
+bool Engine::is_skipping()
+{
+  if (m_is_printing && !m_is_skipping &&
+      m_command_queue->take_skip_request()) {
+    m_is_skipping = true;
+  }
+  return m_is_skipping;
+}
+
+bool Engine::handle_skip_event(const SDL_Event& event)
+{
+  if (event.type != SDL_KEYDOWN ||
+      !m_key_skip_animation.is_in_event(event)) {
+    return false;
+  }
+  // Pressing it while not printing does nothing (but the key still counts
+  // as handled, the same way as the other shortcuts):
+  if (m_is_printing) {
+    m_is_skipping = true;
+  }
+  return true;
+}
+
 bool Engine::handle_window_event(const SDL_Event& event)
 {
   switch (event.type) {
@@ -420,6 +1169,14 @@ bool Engine::handle_window_event(const SDL_Event& event)
         default:
           return true;
       }
+    case SDL_RENDER_TARGETS_RESET:
+    case SDL_RENDER_DEVICE_RESET:
+      // What had been drawn into the textures is gone, so the scaled
+      // background and the composed frame get made again, and the text
+      // redrawn:
+      m_text_display->drop_drawn_content();
+      m_is_composite_outdated = true;
+      return true;
     default:
       break;
   }
@@ -454,26 +1211,182 @@ void Engine::render_window()
     m_window->set_had_window_event(false);
     m_window->refresh_local_flags();
   }
-  if (!m_window->is_visible()) {
+  // When capturing, the frames are wanted even if nobody can see them:
+  if (!m_window->is_visible() && !m_frame_capture) {
     return;
   }
-  if (m_text_display->is_texture_refresh_needed()) {
+  Stopwatch stopwatch {};
+  bool is_full_refresh = m_text_display->is_texture_refresh_needed();
+  if (is_full_refresh) {
     m_text_display->refresh_texture();
   }
   m_text_display->update_cursor();
   if (!m_text_display->has_texture_changed()) {
+    m_stats.render_ms += stopwatch.total_ms();
     return;
   }
   auto* renderer = m_renderer->res();
-  ::SDL_SetRenderTarget(renderer, nullptr);
-  ::SDL_RenderClear(renderer);
-  ::SDL_RenderSetScale(renderer, m_screen_scale, m_screen_scale);
-  ::SDL_RenderCopy(
-      renderer, m_background->res(), nullptr, &m_background_target);
-  ::SDL_RenderCopyF(renderer, m_text_display->res(), nullptr, &m_text_target);
+  if (m_is_composite_outdated) {
+    apply_scale_mode();
+    m_has_composite = rebuild_composite();
+    m_is_composite_outdated = false;
+    is_full_refresh = true;
+  }
+  m_text_display->swap_buffers();
+  if (m_has_composite) {
+    compose_frame(is_full_refresh);
+  } else {
+    ::SDL_SetRenderTarget(renderer, nullptr);
+    ::SDL_RenderClear(renderer);
+    render_background();
+    ::SDL_RenderCopyF(renderer, m_text_display->shown_texture(), nullptr,
+        &m_text_target);
+  }
 
+  if (m_frame_capture) {
+    // Read back the whole output, unscaled:
+    ::SDL_RenderSetScale(renderer, 1.0f, 1.0f);
+    if (m_frame_capture->capture(renderer)) {
+      m_stats.frames_captured++;
+    } else {
+      m_stats.frames_capture_dropped++;
+    }
+  }
   ::SDL_RenderPresent(renderer);
   m_text_display->set_texture_changed(false);
+  record_frame(is_full_refresh);
+  m_stats.render_ms += stopwatch.total_ms();
+  if (m_startup_timings && !m_startup_timings->first_render_ms) {
+    record_first_render(stopwatch);
+  }
+}
+
+void Engine::compose_frame(bool is_full_frame)
+{
+  auto* renderer = m_renderer->res();
+  ::SDL_SetRenderTarget(renderer, m_composed_frame.res());
+  ::SDL_RenderSetScale(renderer, 1.0f, 1.0f);
+  if (is_full_frame) {
+    ::SDL_RenderCopy(renderer, m_scaled_background.res(), nullptr, nullptr);
+  } else {
+    // Only the part of the frame covering what changed in the text area gets
+    // redrawn. The rest of the frame stays as it was.
+    auto area = screen_area_of(m_text_display->dirty_area());
+    ::SDL_RenderSetClipRect(renderer, &area);
+    ::SDL_RenderCopy(renderer, m_scaled_background.res(), &area, &area);
+  }
+  ::SDL_RenderSetScale(renderer, m_screen_scale, m_screen_scale);
+  ::SDL_RenderCopyF(
+      renderer, m_text_display->shown_texture(), nullptr, &m_text_target);
+  ::SDL_RenderSetScale(renderer, 1.0f, 1.0f);
+  ::SDL_RenderSetClipRect(renderer, nullptr);
+  ::SDL_SetRenderTarget(renderer, nullptr);
+  ::SDL_RenderCopy(renderer, m_composed_frame.res(), nullptr, nullptr);
+  // The copy of the composed frame is the one extra, compared to rendering
+  // directly to the window:
+  m_stats.render_copy_calls++;
+  m_stats.render_target_switches++;
+}
+
+SDL_Rect Engine::screen_area_of(const SDL_Rect& text_area) const
+{
+  const auto& text_size = m_text_display->texture_size();
+  const float scale_x = m_text_target.w * m_screen_scale /
+                        static_cast<float>(text_size.width);
+  const float scale_y = m_text_target.h * m_screen_scale /
+                        static_cast<float>(text_size.height);
+  // The texture is scaled with linear filtering, so any changed pixel also
+  // affects its neighbours on the screen:
+  constexpr int filter_margin {2};
+  const float left = m_text_target.x * m_screen_scale +
+                     static_cast<float>(text_area.x) * scale_x;
+  const float top = m_text_target.y * m_screen_scale +
+                    static_cast<float>(text_area.y) * scale_y;
+  const auto x = static_cast<int>(std::floor(left)) - filter_margin;
+  const auto y = static_cast<int>(std::floor(top)) - filter_margin;
+  const auto right = static_cast<int>(std::ceil(
+                         left + static_cast<float>(text_area.w) * scale_x)) +
+                     filter_margin;
+  const auto bottom = static_cast<int>(std::ceil(
+                          top + static_cast<float>(text_area.h) * scale_y)) +
+                      filter_margin;
+  return SDL_Rect {x, y, right - x, bottom - y};
+}
+
+void Engine::record_frame(bool is_full_refresh)
+{
+  constexpr int render_copy_calls {2};
+  m_stats.frames_presented++;
+  m_stats.render_copy_calls += render_copy_calls;
+  m_stats.render_target_switches++;
+  if (is_full_refresh) {
+    m_stats.full_refreshes++;
+  } else {
+    m_stats.partial_refreshes++;
+  }
+  auto now = ::SDL_GetPerformanceCounter();
+  if (m_last_present_counter != 0) {
+    auto frame_ms = Stopwatch::to_ms(now - m_last_present_counter);
+    std::size_t bucket = 0;
+    for (double bucket_limit_ms = 1.0;
+         bucket + 1 < Render_stats::frame_time_buckets &&
+         frame_ms >= bucket_limit_ms;
+         bucket_limit_ms *= 2) {
+      bucket++;
+    }
+    m_stats.frame_time_histogram.at(bucket)++;
+  }
+  m_last_present_counter = now;
+}
+
+std::optional<Renderer_info> Engine::renderer_info() const
+{
+  throw_if_window_closed();
+  SDL_RendererInfo info {};
+  if (::SDL_GetRendererInfo(m_renderer->res(), &info) != 0) {
+    ::SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+        "SDL_GetRendererInfo() failed: %s\n", ::SDL_GetError());
+    return {};
+  }
+  return Renderer_info {info.name == nullptr ? ""s : std::string {info.name},
+      (info.flags & SDL_RENDERER_ACCELERATED) != 0,
+      (info.flags & SDL_RENDERER_PRESENTVSYNC) != 0,
+      (info.flags & SDL_RENDERER_TARGETTEXTURE) != 0,
+      Size {info.max_texture_width, info.max_texture_height}};
+}
+
+Render_stats Engine::stats() const
+{
+  throw_if_window_closed();
+  auto stats = m_stats;
+  const auto& text_stats = m_text_display->stats();
+  stats.render_copy_calls += text_stats.render_copy_calls;
+  stats.render_target_switches += text_stats.render_target_switches;
+  stats.line_cache_hits += text_stats.line_cache_hits;
+  stats.line_cache_misses += text_stats.line_cache_misses;
+  return stats;
+}
+
+void Engine::reset_stats()
+{
+  throw_if_window_closed();
+  m_stats = Render_stats {};
+  m_last_present_counter = 0;
+  m_text_display->reset_stats();
+}
+
+void Engine::record_first_render(const Stopwatch& stopwatch)
+{
+  m_startup_timings->first_render_ms = stopwatch.total_ms();
+  m_startup_timings->until_first_render_ms = Stopwatch::to_ms(
+      ::SDL_GetPerformanceCounter() - m_startup_counter);
+  if (m_do_log_startup_timings) {
+    ::SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION,
+        "Startup timings (ms): first render: %.3f, "
+        "from start of create() until first render: %.3f\n",
+        *m_startup_timings->first_render_ms,
+        *m_startup_timings->until_first_render_ms);
+  }
 }
 
 void Engine::throw_if_window_closed() const
@@ -1,10 +1,13 @@
 #ifndef REMOTEMO_SRC_ENGINE_HPP
 #define REMOTEMO_SRC_ENGINE_HPP
 
+#include <istream>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <memory>
 #include <optional>
+#include <functional>
 
 #include "remotemo/exceptions.hpp"
 #include "remotemo/config.hpp"
@@ -13,6 +16,14 @@
 #include "renderer.hpp"
 #include "background.hpp"
 #include "text_display.hpp"
+#include "stopwatch.hpp"
+#include "clock.hpp"
+#include "command_queue.hpp"
+#include "session_trace.hpp"
+#include "frame_capture.hpp"
+#include "task_scheduler.hpp"
+#include "escape_parser.hpp"
+#include "utf8_decoder.hpp"
 
 #include <SDL.h>
 
@@ -72,15 +83,29 @@ public:
   [[nodiscard]] Point cursor_pos() const;
   [[nodiscard]] Size text_area_size() const;
   [[nodiscard]] char char_at(const Point& pos) const;
+  [[nodiscard]] char32_t code_point_at(const Point& pos) const;
   [[nodiscard]] bool is_inverse_at(const Point& pos) const;
 
+  [[nodiscard]] bool is_valid_cursor_pos(const Point& pos) const;
   void cursor_pos(const Point& pos);
-  bool display_string_at_cursor(
-      const std::string& text, Wrapping text_wrapping);
+  bool display_string_at_cursor(const std::string& text);
+  bool put_string_at_cursor(std::string_view text);
+  // Returns false if some of the text could not get displayed. A failure to
+  // read is left in the state of the stream.
+  bool display_stream(std::istream& input);
 
   void delay(int delay_in_ms);
   Key get_key();
+  void run(const std::function<bool(const Run_step&)>& update_fn,
+      double step_ms);
+  void schedule_after(double delay_ms, std::function<void()>&& task_fn);
+  void schedule_on_key(std::function<void(Key)>&& task_fn);
+  // Returns false if already running.
+  bool run_scheduled();
+  void cancel_scheduled();
   void main_loop_once();
+  void collect_keys(std::vector<Key>* keys);
+  void wait_until(double time_ms);
   void delay_between_chars_ms(int delay_in_ms)
   {
     m_delay_between_chars_ms = delay_in_ms;
@@ -90,6 +115,16 @@ public:
     m_is_scrolling_allowed = is_scrolling_allowed;
   }
   void is_output_inversed(bool inverse);
+  // Also drops any sequence half read and the scroll region.
+  void is_parsing_escapes(bool is_parsing_escapes);
+  [[nodiscard]] bool is_parsing_escapes() const
+  {
+    return m_is_parsing_escapes;
+  }
+  void text_wrapping(Wrapping text_wrapping)
+  {
+    m_text_wrapping = text_wrapping;
+  }
   [[nodiscard]] int delay_between_chars_ms() const
   {
     return m_delay_between_chars_ms;
@@ -99,14 +134,64 @@ public:
     return m_is_scrolling_allowed;
   }
   [[nodiscard]] bool is_output_inversed() const;
-  void clear_screen();
+  [[nodiscard]] Wrapping text_wrapping() const { return m_text_wrapping; }
+  [[nodiscard]] const std::shared_ptr<Command_queue>& command_queue() const
+  {
+    return m_command_queue;
+  }
+  [[nodiscard]] const std::optional<Startup_timings>& startup_timings() const
+  {
+    return m_startup_timings;
+  }
+  [[nodiscard]] std::optional<Renderer_info> renderer_info() const;
+  [[nodiscard]] Render_stats stats() const;
+  void reset_stats();
+  void record(Trace_event&& event);
+  // While paused, nothing gets recorded (e.g. while replaying).
+  [[nodiscard]] bool is_recording_paused() const
+  {
+    return m_is_recording_paused;
+  }
+  void is_recording_paused(bool is_paused)
+  {
+    m_is_recording_paused = is_paused;
+  }
+  [[nodiscard]] double now_ms() const { return m_clock.now_ms(); }
+  void clear_screen(Do_reset do_reset = Do_reset::all);
+  [[nodiscard]] int scrollback_size() const;
+  [[nodiscard]] int view_offset() const;
+  bool view_offset(int offset);
+  [[nodiscard]] Point view_position() const;
+  bool view_position(const Point& pos);
   void close_window();
 
 protected:
   bool handle_standard_event(const SDL_Event& event);
   bool handle_window_event(const SDL_Event& event);
+  bool handle_scrollback_event(const SDL_Event& event);
+  bool handle_skip_event(const SDL_Event& event);
+  bool is_skipping();
   void render_window();
+  void snap_text_target();
+  [[nodiscard]] SDL_ScaleMode scale_mode() const;
+  void apply_scale_mode();
+  // Draws the (scaled) background into the current render target.
+  void render_background();
+  bool rebuild_composite();
+  void compose_frame(bool is_full_frame);
+  [[nodiscard]] SDL_Rect screen_area_of(const SDL_Rect& text_area) const;
+  bool run_queued_commands();
+  void run_command(const Command& command);
+  void record_frame(bool is_full_refresh);
+  void record_first_render(const Stopwatch& stopwatch);
   bool scroll_if_needed(Point* cursor_pos);
+  void line_feed(Point* cursor_pos);
+  // Puts as many of the characters at the start of the text as it can in
+  // one go (if any), moving the cursor past them. Returns how many.
+  std::size_t put_printable_run(std::string_view text, Point* cursor_pos);
+  void run_escape_sequence(Point* cursor_pos);
+  void erase_in_display(int mode, const Point& cursor_pos);
+  void erase_in_line(int mode, const Point& cursor_pos);
   void set_screen_display_settings();
   void refresh_screen_display_settings();
   void throw_if_window_closed() const;
@@ -121,15 +206,50 @@ private:
   Key_combo_handler m_key_fullscreen;
   Key_combo_handler m_key_close_window;
   Key_combo_handler m_key_quit;
+  Key_combo_handler m_key_scroll_back;
+  Key_combo_handler m_key_scroll_forward;
+  Key_combo_handler m_key_skip_animation;
   bool m_is_closing_same_as_quit;
   std::function<bool()> m_pre_close_function;
   std::function<bool()> m_pre_quit_function;
+  Scaling_mode m_scaling_mode;
   bool m_is_scrolling_allowed {true};
   int m_delay_between_chars_ms {60};
+  Wrapping m_text_wrapping {Wrapping::character};
+  bool m_is_parsing_escapes {false};
+  Escape_parser m_escape_parser {};
+  Utf8_decoder m_utf8_decoder {};
+  // The top and bottom lines (inclusive) of the part of the text area that
+  // scrolls, if set (by an escape sequence) to less than all of it:
+  std::optional<std::pair<int, int>> m_scroll_region {};
   float m_screen_scale {1.0f};
   SDL_Rect m_background_target {};
   SDL_FRect m_text_target {};
+  // The background, already scaled to the window, and the last composed
+  // frame. Rebuilt after the screen display settings have changed.
+  Res_handler<SDL_Texture> m_scaled_background {};
+  Res_handler<SDL_Texture> m_composed_frame {};
+  bool m_is_composite_outdated {true};
+  bool m_has_composite {false};
+  std::optional<Startup_timings> m_startup_timings {};
+  Uint64 m_startup_counter {0};
+  bool m_do_log_startup_timings {false};
+  // The counters that concern the text area are kept by m_text_display:
+  Render_stats m_stats {};
+  Uint64 m_last_present_counter {0};
+  std::shared_ptr<Command_queue> m_command_queue;
+  bool m_is_busy {false};
+  bool m_is_printing {false};
+  // Whether the rest of the text being printed goes out at once:
+  bool m_is_skipping {false};
+  std::optional<Session_recorder> m_recorder {};
+  bool m_is_recording_paused {false};
+  Clock m_clock;
+  std::unique_ptr<Frame_capture> m_frame_capture {};
+  Task_scheduler m_scheduler {};
+  bool m_is_running_scheduled {false};
   static constexpr Uint32 sdl_init_flags {SDL_INIT_VIDEO};
+  static constexpr std::size_t stream_chunk_size {std::size_t {64} * 1024};
 };
 } // namespace remotemo
 #endif // REMOTEMO_SRC_ENGINE_HPP
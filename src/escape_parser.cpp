@@ -0,0 +1,128 @@
+#include "escape_parser.hpp"
+
+namespace remotemo {
+namespace {
+constexpr char escape_char {0x1b};
+constexpr int decimal_base {10};
+constexpr unsigned char first_printable {0x20};
+constexpr unsigned char last_intermediate {0x2f};
+constexpr unsigned char first_private_marker {0x3c};
+constexpr unsigned char last_private_marker {0x3f};
+constexpr unsigned char first_final {0x40};
+constexpr unsigned char last_final {0x7e};
+} // namespace
+
+const Escape_parser::Table& Escape_parser::transitions()
+{
+  using S = State;
+  using A = Action;
+  // Columns, in the order of Char_class: control, escape, left_bracket,
+  // digit, separator, private_marker, intermediate, final, other.
+  static const Table table {{
+      // ground:
+      {{{S::ground, A::print}, {S::escape, A::none}, {S::ground, A::print},
+          {S::ground, A::print}, {S::ground, A::print},
+          {S::ground, A::print}, {S::ground, A::print},
+          {S::ground, A::print}, {S::ground, A::print}}},
+      // escape (any other sequence than CSI gets ignored):
+      {{{S::escape, A::print}, {S::escape, A::none},
+          {S::csi_param, A::clear}, {S::ground, A::none},
+          {S::ground, A::none}, {S::ground, A::none},
+          {S::escape, A::none}, {S::ground, A::none},
+          {S::ground, A::none}}},
+      // csi_param ('[' is out of place, so the sequence is not valid):
+      {{{S::csi_param, A::print}, {S::escape, A::none},
+          {S::csi_ignore, A::none}, {S::csi_param, A::collect},
+          {S::csi_param, A::next_param}, {S::csi_ignore, A::none},
+          {S::csi_ignore, A::none}, {S::ground, A::dispatch},
+          {S::csi_param, A::none}}},
+      // csi_ignore (e.g. private sequences, which are not supported):
+      {{{S::csi_ignore, A::print}, {S::escape, A::none},
+          {S::ground, A::none}, {S::csi_ignore, A::none},
+          {S::csi_ignore, A::none}, {S::csi_ignore, A::none},
+          {S::csi_ignore, A::none}, {S::ground, A::none},
+          {S::csi_ignore, A::none}}},
+  }};
+  return table;
+}
+
+Escape_parser::Char_class Escape_parser::classify(char character)
+{
+  const auto byte = static_cast<unsigned char>(character);
+  if (character == escape_char) {
+    return Char_class::escape;
+  }
+  if (byte < first_printable) {
+    return Char_class::control;
+  }
+  if (character == '[') {
+    return Char_class::left_bracket;
+  }
+  if (character >= '0' && character <= '9') {
+    return Char_class::digit;
+  }
+  if (character == ';') {
+    return Char_class::separator;
+  }
+  if (byte >= first_private_marker && byte <= last_private_marker) {
+    return Char_class::private_marker;
+  }
+  if (byte <= last_intermediate) {
+    return Char_class::intermediate;
+  }
+  if (byte >= first_final && byte <= last_final) {
+    return Char_class::final;
+  }
+  // I.e. ':', DEL and anything not ASCII:
+  return Char_class::other;
+}
+
+Escape_parser::Result Escape_parser::feed(char character)
+{
+  const auto& transition =
+      transitions()[static_cast<std::size_t>(m_state)]
+                   [static_cast<std::size_t>(classify(character))];
+  m_state = transition.next;
+  switch (transition.action) {
+    case Action::print:
+      return Result::print;
+    case Action::clear:
+      m_params.fill(0);
+      m_param_index = 0;
+      break;
+    case Action::collect: {
+      auto& value = m_params[static_cast<std::size_t>(m_param_index)];
+      value = value * decimal_base + (character - '0');
+      if (value > max_param_value) {
+        value = max_param_value;
+      }
+      break;
+    }
+    case Action::next_param:
+      if (m_param_index < max_params - 1) {
+        m_param_index++;
+      }
+      break;
+    case Action::dispatch:
+      m_final_char = character;
+      return Result::sequence;
+    case Action::none:
+      break;
+  }
+  return Result::none;
+}
+
+void Escape_parser::reset()
+{
+  m_state = State::ground;
+}
+
+int Escape_parser::param(int index, int default_value) const
+{
+  if (index < 0 || index > m_param_index) {
+    return default_value;
+  }
+  auto value = m_params[static_cast<std::size_t>(index)];
+  return value == 0 ? default_value : value;
+}
+} // namespace remotemo
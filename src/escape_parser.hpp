@@ -0,0 +1,72 @@
+#ifndef REMOTEMO_SRC_ESCAPE_PARSER_HPP
+#define REMOTEMO_SRC_ESCAPE_PARSER_HPP
+
+#include <array>
+#include <cstddef>
+
+namespace remotemo {
+// Splits the text being printed into characters and ANSI/VT control
+// sequences (only CSI ones, i.e. "ESC [ <params> <final>", the other escape
+// sequences get ignored). Fed one character at a time, so a sequence can be
+// split over several calls to print().
+//
+// Driven by a table of what to do for each class of character in each
+// state, along the lines of the DEC parser described at
+// https://vt100.net/emu/dec_ansi_parser
+class Escape_parser {
+public:
+  enum class Result {
+    none,    // Part of a sequence, nothing to do (yet).
+    print,   // To be handled as usual (including '\n' and the like).
+    sequence // A sequence has ended, see final_char() and param().
+  };
+
+  Result feed(char character);
+  // Back to expecting plain text, dropping any sequence half read.
+  void reset();
+  // Whether it is expecting plain text, i.e. not in the middle of a
+  // sequence.
+  [[nodiscard]] bool is_idle() const { return m_state == State::ground; }
+  [[nodiscard]] char final_char() const { return m_final_char; }
+  [[nodiscard]] int param_count() const { return m_param_index + 1; }
+  // Missing parameters and those set to 0 get the default value.
+  [[nodiscard]] int param(int index, int default_value) const;
+
+  static constexpr int max_params {8};
+  static constexpr int max_param_value {9999};
+
+private:
+  enum class State { ground, escape, csi_param, csi_ignore, count };
+  enum class Char_class {
+    control,
+    escape,
+    left_bracket,
+    digit,
+    separator,
+    private_marker,
+    intermediate,
+    final,
+    other,
+    count
+  };
+  enum class Action { none, print, clear, collect, next_param, dispatch };
+  struct Transition {
+    State next;
+    Action action;
+  };
+  static constexpr auto state_count = static_cast<std::size_t>(State::count);
+  static constexpr auto class_count =
+      static_cast<std::size_t>(Char_class::count);
+  using Table =
+      std::array<std::array<Transition, class_count>, state_count>;
+
+  static Char_class classify(char character);
+  static const Table& transitions();
+
+  State m_state {State::ground};
+  std::array<int, max_params> m_params {};
+  int m_param_index {0};
+  char m_final_char {0};
+};
+} // namespace remotemo
+#endif // REMOTEMO_SRC_ESCAPE_PARSER_HPP
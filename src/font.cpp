@@ -1,15 +1,198 @@
 #include "font.hpp"
 
+#include <algorithm>
+#include <climits>
+
 namespace remotemo {
+namespace {
+constexpr int bytes_per_pixel {4};
+constexpr Uint8 max_intensity {255};
+
+void warn_inverse_not_made()
+{
+  SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+      "Could not make the inversed glyphs of the font: %s\n",
+      ::SDL_GetError());
+}
+
+// Puts the inverse of the upper half of the (RGBA32) pixels into the lower
+// half. The inversed pixels are opaque, and what was transparent (i.e. the
+// background of a glyph) gets lit, the same way as what was black does.
+void invert_into_lower_half(Uint8* pixels, int pitch, int half_height)
+{
+  constexpr int alpha_index {bytes_per_pixel - 1};
+  const auto half_size = static_cast<std::size_t>(pitch) * half_height;
+  for (std::size_t i = 0; i < half_size; i += bytes_per_pixel) {
+    const int alpha = pixels[i + alpha_index];
+    for (std::size_t color = 0; color < alpha_index; color++) {
+      // The color as it shows over black, then inversed:
+      const int shown = pixels[i + color] * alpha / max_intensity;
+      pixels[half_size + i + color] =
+          static_cast<Uint8>(max_intensity - shown);
+    }
+    pixels[half_size + i + alpha_index] = max_intensity;
+  }
+}
+
+// The bitmap with its inversed glyphs below it, or nullptr if that could not
+// be made.
+SDL_Surface* with_inversed_glyphs(SDL_Surface* bitmap)
+{
+  // Converted first, so that any color key ends up in the alpha:
+  Res_handler<SDL_Surface> converted {
+      SDL_ConvertSurfaceFormat(bitmap, SDL_PIXELFORMAT_RGBA32, 0)};
+  if (converted.res() == nullptr) {
+    return nullptr;
+  }
+  const int width = converted.res()->w;
+  const int height = converted.res()->h;
+  auto* doubled = SDL_CreateRGBSurfaceWithFormat(0, width, 2 * height,
+      bytes_per_pixel * CHAR_BIT, SDL_PIXELFORMAT_RGBA32);
+  if (doubled == nullptr) {
+    return nullptr;
+  }
+  auto* pixels = static_cast<Uint8*>(doubled->pixels);
+  const auto* converted_pixels =
+      static_cast<const Uint8*>(converted.res()->pixels);
+  const auto row_size = static_cast<std::size_t>(width) * bytes_per_pixel;
+  for (int y = 0; y < height; y++) {
+    std::copy_n(converted_pixels + y * converted.res()->pitch, row_size,
+        pixels + y * doubled->pitch);
+  }
+  invert_into_lower_half(pixels, doubled->pitch, height);
+  return doubled;
+}
+} // namespace
+
 std::optional<Font> Font::create(const Font_config& font_config,
-    Res_handler<SDL_Texture>&& font_texture, SDL_Renderer* renderer)
+    Res_handler<SDL_Texture>&& font_texture, Surface_loader&& font_surface,
+    SDL_Renderer* renderer)
 {
   Font font {font_config, Texture {std::move(font_texture)}};
   if (font_config.raw_sdl == nullptr) {
-    if (!font.load(renderer, font_config.file_path)) {
+    Res_handler<SDL_Surface> bitmap {font_surface.get()};
+    if (bitmap.res() == nullptr) {
       return {};
     }
+    // Made here, before the bitmap gets uploaded, rather than by reading the
+    // texture back from the renderer:
+    if (bitmap.res()->h / font.m_char_height == bitmap_lines_per_mode) {
+      Res_handler<SDL_Surface> inversed {with_inversed_glyphs(bitmap.res())};
+      if (inversed.res() != nullptr) {
+        bitmap = std::move(inversed);
+      } else {
+        warn_inverse_not_made();
+      }
+    }
+    if (!font.load(renderer, bitmap.res(), font_surface.name())) {
+      return {};
+    }
+    font.m_is_inverse_checked = true;
   }
   return font;
 }
+
+int Font::page_count()
+{
+  if (m_page_count > 0) {
+    return m_page_count;
+  }
+  auto height = texture_size().height;
+  if (height == 0 && res() != nullptr) {
+    // A texture handed over in the config, so its size is not known yet:
+    SDL_QueryTexture(res(), nullptr, nullptr, nullptr, &height);
+  }
+  const int page_height = 2 * bitmap_lines_per_mode * m_char_height;
+  m_page_count =
+      std::clamp(page_height > 0 ? height / page_height : 1, 1, max_pages);
+  return m_page_count;
+}
+
+void Font::add_inverse_if_missing(SDL_Renderer* renderer)
+{
+  if (m_is_inverse_checked) {
+    return;
+  }
+  m_is_inverse_checked = true;
+  auto size = texture_size();
+  if (size.height == 0 && res() != nullptr) {
+    SDL_QueryTexture(res(), nullptr, nullptr, &size.width, &size.height);
+  }
+  if (size.height / m_char_height != bitmap_lines_per_mode) {
+    return;
+  }
+  // Only a texture handed over in the config ends up here, so the glyphs
+  // have to be read back, through a texture they get copied to as they are:
+  Res_handler<SDL_Texture> copy {SDL_CreateTexture(renderer,
+      SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, size.width,
+      size.height)};
+  Res_handler<SDL_Surface> surface {SDL_CreateRGBSurfaceWithFormat(0,
+      size.width, 2 * size.height, bytes_per_pixel * CHAR_BIT,
+      SDL_PIXELFORMAT_RGBA32)};
+  if (copy.res() == nullptr || surface.res() == nullptr) {
+    warn_inverse_not_made();
+    return;
+  }
+  SDL_BlendMode blend_mode {SDL_BLENDMODE_NONE};
+  SDL_GetTextureBlendMode(res(), &blend_mode);
+  SDL_SetTextureBlendMode(res(), SDL_BLENDMODE_NONE);
+  auto* previous_target = SDL_GetRenderTarget(renderer);
+  SDL_SetRenderTarget(renderer, copy.res());
+  SDL_RenderCopy(renderer, res(), nullptr, nullptr);
+  auto* pixels = static_cast<Uint8*>(surface.res()->pixels);
+  const int pitch = surface.res()->pitch;
+  const bool is_read = SDL_RenderReadPixels(renderer, nullptr,
+                           SDL_PIXELFORMAT_RGBA32, pixels, pitch) == 0;
+  SDL_SetRenderTarget(renderer, previous_target);
+  SDL_SetTextureBlendMode(res(), blend_mode);
+  if (!is_read) {
+    warn_inverse_not_made();
+    return;
+  }
+  invert_into_lower_half(pixels, pitch, size.height);
+  Texture font_texture {
+      SDL_CreateTextureFromSurface(renderer, surface.res())};
+  if (font_texture.res() == nullptr) {
+    warn_inverse_not_made();
+    return;
+  }
+  SDL_SetTextureBlendMode(font_texture.res(), blend_mode);
+  static_cast<Res_handler<SDL_Texture>&>(*this) = std::move(font_texture);
+  texture_size(Size {size.width, 2 * size.height});
+}
+
+std::optional<Glyph> Font::glyph_of(char32_t code_point)
+{
+  const auto pages = static_cast<std::size_t>(page_count());
+  for (std::size_t page = 0; page < pages; page++) {
+    const auto first = page_first_code_points[page];
+    if (code_point >= first && code_point < first + glyphs_per_page) {
+      return static_cast<Glyph>(page * glyphs_per_page + code_point - first);
+    }
+  }
+  return {};
+}
+
+char32_t Font::code_point_of(Glyph glyph)
+{
+  const auto page = static_cast<std::size_t>(glyph / glyphs_per_page);
+  if (page >= page_first_code_points.size()) {
+    return 0;
+  }
+  return page_first_code_points[page] + glyph % glyphs_per_page;
+}
+
+SDL_Rect Font::glyph_area(Glyph glyph, bool is_inversed) const
+{
+  const int page = glyph / glyphs_per_page;
+  const int index = glyph % glyphs_per_page;
+  int bitmap_char_column = index % bitmap_char_per_line;
+  int bitmap_char_line =
+      (page * 2 * bitmap_lines_per_mode) + index / bitmap_char_per_line;
+  if (is_inversed) {
+    bitmap_char_line += bitmap_lines_per_mode;
+  }
+  return SDL_Rect {bitmap_char_column * m_char_width,
+      bitmap_char_line * m_char_height, m_char_width, m_char_height};
+}
 } // namespace remotemo
@@ -1,6 +1,7 @@
 #ifndef REMOTEMO_SRC_FONT_HPP
 #define REMOTEMO_SRC_FONT_HPP
 
+#include <array>
 #include <utility>
 #include <string>
 #include <optional>
@@ -8,9 +9,16 @@
 #include "remotemo/config.hpp"
 #include "res_handler.hpp"
 #include "texture.hpp"
+#include "display_square.hpp"
 #include <SDL.h>
 
 namespace remotemo {
+// The font bitmap is made of pages, one below the other, each with 128
+// glyphs in 8 lines of 16, followed by the same glyphs inversed. The first
+// page is ASCII, and the other ones (if the bitmap has them) cover the
+// blocks of code points in page_first_code_points. A bitmap of only the 8
+// lines of ASCII gets its inversed glyphs made when loaded, or (if handed
+// over as a texture in the config) by add_inverse_if_missing().
 class Font : public Texture {
 public:
   Font(const Font_config& font_config, Texture&& font_texture) noexcept
@@ -19,13 +27,35 @@ public:
   {}
 
   static std::optional<Font> create(const Font_config& font_config,
-      Res_handler<SDL_Texture>&& font_texture, SDL_Renderer* renderer);
+      Res_handler<SDL_Texture>&& font_texture, Surface_loader&& font_surface,
+      SDL_Renderer* renderer);
   [[nodiscard]] int char_width() const { return m_char_width; }
   [[nodiscard]] int char_height() const { return m_char_height; }
+  // Number of pages in the bitmap. Found out the first time it is needed.
+  int page_count();
+  // The glyph for the code point, if the bitmap has it.
+  std::optional<Glyph> glyph_of(char32_t code_point);
+  [[nodiscard]] static char32_t code_point_of(Glyph glyph);
+  [[nodiscard]] SDL_Rect glyph_area(Glyph glyph, bool is_inversed) const;
+  // Has to be called before drawing any glyph. Only does something the
+  // first time, and then only if the bitmap was handed over as a texture
+  // and lacks the inversed glyphs.
+  void add_inverse_if_missing(SDL_Renderer* renderer);
+
+  static constexpr int glyphs_per_page {128};
+  static constexpr int max_pages {4};
+  // Latin-1, box drawing, block elements (and the geometric shapes after
+  // them). Each block is 128 code points, starting at a multiple of 128.
+  static constexpr std::array<char32_t, max_pages> page_first_code_points {
+      0x0000, 0x0080, 0x2500, 0x2580};
+  static constexpr int bitmap_char_per_line {16};
+  static constexpr int bitmap_lines_per_mode {8};
 
 private:
   int m_char_width;
   int m_char_height;
+  int m_page_count {0};
+  bool m_is_inverse_checked {false};
 };
 } // namespace remotemo
 #endif // REMOTEMO_SRC_FONT_HPP
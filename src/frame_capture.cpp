@@ -0,0 +1,157 @@
+#include "frame_capture.hpp"
+
+#include <array>
+#include <climits>
+#include <cstdio>
+#include <system_error>
+
+#include <SDL_image.h>
+
+namespace remotemo {
+std::unique_ptr<Frame_capture> Frame_capture::create(
+    const std::string& path_prefix, Capture_format format)
+{
+  // NOTE Not using std::make_unique() since the constructor is private.
+  std::unique_ptr<Frame_capture> capture {
+      new Frame_capture {path_prefix, format}};
+  if (format == Capture_format::raw) {
+    auto raw_path = path_prefix + ".rgb";
+    capture->m_raw_file.open(raw_path, std::ios::binary | std::ios::trunc);
+    if (!capture->m_raw_file) {
+      SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
+          "Could not open '%s' for capturing the frames\n", raw_path.c_str());
+      return nullptr;
+    }
+  }
+  capture->m_free_frames.resize(pool_size);
+  try {
+    capture->m_encoder = std::thread {&Frame_capture::encode_frames,
+        capture.get()};
+  } catch (const std::system_error& e) {
+    SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
+        "Could not start the thread for capturing the frames: %s\n",
+        e.what());
+    return nullptr;
+  }
+  return capture;
+}
+
+Frame_capture::~Frame_capture()
+{
+  {
+    std::lock_guard<std::mutex> lock {m_mutex};
+    m_is_stopping = true;
+  }
+  m_frame_queued.notify_one();
+  if (m_encoder.joinable()) {
+    // Any frames still queued get written before this returns:
+    m_encoder.join();
+  }
+}
+
+bool Frame_capture::capture(SDL_Renderer* renderer)
+{
+  Frame frame {};
+  {
+    std::lock_guard<std::mutex> lock {m_mutex};
+    if (m_free_frames.empty()) {
+      return false;
+    }
+    frame = std::move(m_free_frames.back());
+    m_free_frames.pop_back();
+  }
+  auto release = [this](Frame&& unused_frame) {
+    std::lock_guard<std::mutex> lock {m_mutex};
+    m_free_frames.push_back(std::move(unused_frame));
+  };
+  if (::SDL_GetRendererOutputSize(renderer, &frame.width, &frame.height) !=
+      0) {
+    release(std::move(frame));
+    return false;
+  }
+  const int pitch = frame.width * bytes_per_pixel;
+  // Keeps its capacity, so once the pool has warmed up (and as long as the
+  // size of the window stays the same), there is no allocation here:
+  frame.pixels.resize(static_cast<std::size_t>(pitch) * frame.height);
+  if (::SDL_RenderReadPixels(renderer, nullptr, SDL_PIXELFORMAT_RGB24,
+          frame.pixels.data(), pitch) != 0) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to read back the frame: %s\n", ::SDL_GetError());
+    release(std::move(frame));
+    return false;
+  }
+  frame.number = m_next_frame_number++;
+  {
+    std::lock_guard<std::mutex> lock {m_mutex};
+    m_queued_frames.push_back(std::move(frame));
+  }
+  m_frame_queued.notify_one();
+  return true;
+}
+
+void Frame_capture::encode_frames()
+{
+  std::unique_lock<std::mutex> lock {m_mutex};
+  while (true) {
+    m_frame_queued.wait(lock,
+        [this]() { return m_is_stopping || !m_queued_frames.empty(); });
+    if (m_queued_frames.empty()) {
+      // Stopping, and everything has been written.
+      return;
+    }
+    auto frame = std::move(m_queued_frames.front());
+    m_queued_frames.pop_front();
+    lock.unlock();
+    write_frame(frame);
+    lock.lock();
+    m_free_frames.push_back(std::move(frame));
+  }
+}
+
+std::string Frame_capture::frame_path(Uint64 number) const
+{
+  constexpr std::size_t max_digits {24};
+  std::array<char, max_digits> digits {};
+  std::snprintf(digits.data(), digits.size(), "%06llu",
+      static_cast<unsigned long long>(number)); // NOLINT(google-runtime-int)
+  return m_path_prefix + digits.data() +
+         (m_format == Capture_format::png ? ".png" : ".ppm");
+}
+
+void Frame_capture::write_frame(const Frame& frame)
+{
+  const auto pixels_size = static_cast<std::streamsize>(frame.pixels.size());
+  if (m_format == Capture_format::raw) {
+    // NOTE All the frames of a raw stream are expected to be of the same
+    // size, so the size of the window should not change while capturing.
+    m_raw_file.write(
+        reinterpret_cast<const char*>(frame.pixels.data()), // NOLINT
+        pixels_size);
+    return;
+  }
+  auto path = frame_path(frame.number);
+  if (m_format == Capture_format::ppm) {
+    std::ofstream file {path, std::ios::binary | std::ios::trunc};
+    file << "P6\n" << frame.width << ' ' << frame.height << "\n255\n";
+    file.write(
+        reinterpret_cast<const char*>(frame.pixels.data()), // NOLINT
+        pixels_size);
+    if (!file) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+          "Failed to write the frame to '%s'\n", path.c_str());
+    }
+    return;
+  }
+  // SDL only reads from the pixels, even though the pointer is not const:
+  auto* surface = ::SDL_CreateRGBSurfaceWithFormatFrom(
+      const_cast<Uint8*>(frame.pixels.data()), // NOLINT
+      frame.width, frame.height, bytes_per_pixel * CHAR_BIT,
+      frame.width * bytes_per_pixel, SDL_PIXELFORMAT_RGB24);
+  if (surface == nullptr || ::IMG_SavePNG(surface, path.c_str()) != 0) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to write the frame to '%s': %s\n", path.c_str(),
+        ::SDL_GetError());
+  }
+  ::SDL_FreeSurface(surface);
+}
+} // namespace remotemo
@@ -0,0 +1,66 @@
+#ifndef REMOTEMO_SRC_FRAME_CAPTURE_HPP
+#define REMOTEMO_SRC_FRAME_CAPTURE_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "remotemo/common_types.hpp"
+
+#include <SDL.h>
+
+namespace remotemo {
+// Reads back the rendered frames and hands them over to an encoder thread
+// that writes them to files. The pixel buffers are pooled, and if the
+// encoder falls behind (so that there is no free buffer), then frames get
+// dropped rather than making the rendering wait.
+class Frame_capture {
+public:
+  static std::unique_ptr<Frame_capture> create(
+      const std::string& path_prefix, Capture_format format);
+
+  ~Frame_capture();
+  Frame_capture(Frame_capture&&) = delete;
+  Frame_capture& operator=(Frame_capture&&) = delete;
+  Frame_capture(const Frame_capture&) = delete;
+  Frame_capture& operator=(const Frame_capture&) = delete;
+
+  // Must be called (on the rendering thread) after everything has been
+  // rendered but before presenting. Returns false if the frame got dropped.
+  bool capture(SDL_Renderer* renderer);
+
+private:
+  struct Frame {
+    std::vector<Uint8> pixels {};
+    int width {0};
+    int height {0};
+    Uint64 number {0};
+  };
+  static constexpr std::size_t pool_size {4};
+  static constexpr int bytes_per_pixel {3};
+
+  Frame_capture(std::string path_prefix, Capture_format format) noexcept
+      : m_path_prefix(std::move(path_prefix)), m_format(format)
+  {}
+  void encode_frames();
+  void write_frame(const Frame& frame);
+  [[nodiscard]] std::string frame_path(Uint64 number) const;
+
+  std::string m_path_prefix;
+  Capture_format m_format;
+  std::ofstream m_raw_file {};
+  Uint64 m_next_frame_number {0};
+  std::mutex m_mutex {};
+  std::condition_variable m_frame_queued {};
+  std::vector<Frame> m_free_frames {};
+  std::deque<Frame> m_queued_frames {};
+  bool m_is_stopping {false};
+  std::thread m_encoder {};
+};
+} // namespace remotemo
+#endif // REMOTEMO_SRC_FRAME_CAPTURE_HPP
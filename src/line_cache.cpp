@@ -0,0 +1,38 @@
+#include "line_cache.hpp"
+
+namespace remotemo {
+std::optional<int> Line_cache::find(const std::string& line)
+{
+  auto found = m_slots.find(line);
+  if (found == m_slots.end()) {
+    return {};
+  }
+  m_entries.splice(m_entries.begin(), m_entries, found->second);
+  return found->second->slot;
+}
+
+int Line_cache::insert(const std::string& line)
+{
+  auto found = m_slots.find(line);
+  if (found != m_slots.end()) {
+    m_entries.splice(m_entries.begin(), m_entries, found->second);
+    return found->second->slot;
+  }
+  int slot = static_cast<int>(m_entries.size());
+  if (slot >= m_capacity) {
+    // Reuse the slot of the least recently used line:
+    slot = m_entries.back().slot;
+    m_slots.erase(m_entries.back().line);
+    m_entries.pop_back();
+  }
+  m_entries.push_front(Entry {line, slot});
+  m_slots.emplace(line, m_entries.begin());
+  return slot;
+}
+
+void Line_cache::clear()
+{
+  m_entries.clear();
+  m_slots.clear();
+}
+} // namespace remotemo
@@ -0,0 +1,42 @@
+#ifndef REMOTEMO_SRC_LINE_CACHE_HPP
+#define REMOTEMO_SRC_LINE_CACHE_HPP
+
+#include <list>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace remotemo {
+// Keeps track of which lines are in which slot of a fixed number of slots,
+// dropping the least recently used line when a new one needs a slot. A line
+// is identified by its content, two bytes per character (the glyph, with
+// the attributes in the top bit), so two lines only share a slot if they
+// look the same.
+class Line_cache {
+public:
+  explicit Line_cache(int capacity) noexcept
+      : m_capacity(capacity < 0 ? 0 : capacity)
+  {}
+
+  [[nodiscard]] int capacity() const { return m_capacity; }
+  // Returns the slot of the line (marking it as the most recently used), or
+  // nothing if it is not in the cache.
+  std::optional<int> find(const std::string& line);
+  // Returns the slot the line should be stored in. Must not be called when
+  // the capacity is 0.
+  int insert(const std::string& line);
+  void clear();
+
+private:
+  struct Entry {
+    std::string line;
+    int slot;
+  };
+
+  int m_capacity;
+  // The most recently used first:
+  std::list<Entry> m_entries {};
+  std::unordered_map<std::string, std::list<Entry>::iterator> m_slots {};
+};
+} // namespace remotemo
+#endif // REMOTEMO_SRC_LINE_CACHE_HPP
@@ -0,0 +1,89 @@
+#include "mapped_file.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <SDL.h>
+
+namespace remotemo {
+std::optional<Mapped_file> Mapped_file::create(const std::string& file_path)
+{
+  Mapped_file file {};
+#ifdef _WIN32
+  std::ifstream stream {file_path, std::ios::binary};
+  if (!stream) {
+    SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
+        "Could not open '%s'\n", file_path.c_str());
+    return {};
+  }
+  file.m_buffer.assign(std::istreambuf_iterator<char> {stream},
+      std::istreambuf_iterator<char> {});
+  file.m_data = file.m_buffer.data();
+  file.m_size = file.m_buffer.size();
+#else
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+  const int descriptor = ::open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (descriptor < 0) {
+    SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
+        "Could not open '%s'\n", file_path.c_str());
+    return {};
+  }
+  struct stat status {};
+  if (::fstat(descriptor, &status) != 0 || !S_ISREG(status.st_mode)) {
+    SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
+        "'%s' is not a regular file\n", file_path.c_str());
+    ::close(descriptor);
+    return {};
+  }
+  file.m_size = static_cast<std::size_t>(status.st_size);
+  if (file.m_size > 0) {
+    auto* data = ::mmap(
+        nullptr, file.m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (data == MAP_FAILED) { // NOLINT
+      SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
+          "Could not map '%s' into memory\n", file_path.c_str());
+      ::close(descriptor);
+      return {};
+    }
+    file.m_data = static_cast<const char*>(data);
+    file.m_is_mapped = true;
+  }
+  // The mapping stays valid after closing the file:
+  ::close(descriptor);
+#endif
+  return file;
+}
+
+Mapped_file::~Mapped_file()
+{
+#ifndef _WIN32
+  if (m_is_mapped) {
+    ::munmap(const_cast<char*>(m_data), m_size); // NOLINT
+  }
+#endif
+}
+
+Mapped_file::Mapped_file(Mapped_file&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)),
+      m_size(std::exchange(other.m_size, 0)),
+      m_is_mapped(std::exchange(other.m_is_mapped, false)),
+      m_buffer(std::move(other.m_buffer))
+{}
+
+Mapped_file& Mapped_file::operator=(Mapped_file&& other) noexcept
+{
+  std::swap(m_data, other.m_data);
+  std::swap(m_size, other.m_size);
+  std::swap(m_is_mapped, other.m_is_mapped);
+  std::swap(m_buffer, other.m_buffer);
+  return *this;
+}
+} // namespace remotemo
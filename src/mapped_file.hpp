@@ -0,0 +1,38 @@
+#ifndef REMOTEMO_SRC_MAPPED_FILE_HPP
+#define REMOTEMO_SRC_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace remotemo {
+// A file mapped (read-only) into memory, so that it can be parsed without
+// copying it first. Where mapping is not available (i.e. on Windows), the
+// file gets read into memory instead.
+class Mapped_file {
+public:
+  static std::optional<Mapped_file> create(const std::string& file_path);
+
+  ~Mapped_file();
+  Mapped_file(Mapped_file&& other) noexcept;
+  Mapped_file& operator=(Mapped_file&& other) noexcept;
+  Mapped_file(const Mapped_file&) = delete;
+  Mapped_file& operator=(const Mapped_file&) = delete;
+
+  [[nodiscard]] std::string_view bytes() const
+  {
+    return std::string_view {m_data, m_size};
+  }
+
+private:
+  Mapped_file() noexcept = default;
+
+  const char* m_data {nullptr};
+  std::size_t m_size {0};
+  bool m_is_mapped {false};
+  std::vector<char> m_buffer {};
+};
+} // namespace remotemo
+#endif // REMOTEMO_SRC_MAPPED_FILE_HPP
@@ -1,5 +1,6 @@
 #include <remotemo/remotemo.hpp>
 
+#include <fstream>
 #include <sstream>
 #include <vector>
 
@@ -7,6 +8,46 @@
 #include "engine.hpp"
 
 namespace remotemo {
+namespace {
+// Keeps the engine from recording for as long as it exists (restoring the
+// previous state afterwards, so that it can be nested).
+class Recording_pause {
+public:
+  explicit Recording_pause(Engine* engine) noexcept
+      : m_engine(engine), m_was_paused(engine->is_recording_paused())
+  {
+    m_engine->is_recording_paused(true);
+  }
+  ~Recording_pause() { m_engine->is_recording_paused(m_was_paused); }
+  Recording_pause(Recording_pause&&) = delete;
+  Recording_pause& operator=(Recording_pause&&) = delete;
+  Recording_pause(const Recording_pause&) = delete;
+  Recording_pause& operator=(const Recording_pause&) = delete;
+
+private:
+  Engine* m_engine;
+  bool m_was_paused;
+};
+
+// Puts the delay between characters back the way it was, once it goes out of
+// scope.
+class Text_delay_keeper {
+public:
+  explicit Text_delay_keeper(Engine* engine) noexcept
+      : m_engine(engine), m_delay_ms(engine->delay_between_chars_ms())
+  {}
+  ~Text_delay_keeper() { m_engine->delay_between_chars_ms(m_delay_ms); }
+  Text_delay_keeper(Text_delay_keeper&&) = delete;
+  Text_delay_keeper& operator=(Text_delay_keeper&&) = delete;
+  Text_delay_keeper(const Text_delay_keeper&) = delete;
+  Text_delay_keeper& operator=(const Text_delay_keeper&) = delete;
+
+private:
+  Engine* m_engine;
+  int m_delay_ms;
+};
+} // namespace
+
 Remotemo::~Remotemo() noexcept = default;
 Remotemo::Remotemo(Remotemo&& other) noexcept = default;
 Remotemo& Remotemo::operator=(Remotemo&& other) noexcept = default;
@@ -70,19 +111,19 @@ int Remotemo::move_cursor(const Size& move)
     new_pos.y = 0;
     return_code += static_cast<int>(Move_cursor_error::past_top_edge);
   }
+  m_engine->record(
+      Trace_event {Trace_event::Type::set_cursor, 0, {}, new_pos});
   m_engine->cursor_pos(new_pos);
   return return_code;
 }
 
 int Remotemo::set_cursor(const Point& pos)
 {
-  auto area_size = m_engine->text_area_size();
-  if (pos.x < 0 || pos.x >= area_size.width ||
-      // NOTE Cursor is allowed to be one line below visible area:
-      pos.y < 0 || pos.y > area_size.height) {
+  if (!m_engine->is_valid_cursor_pos(pos)) {
     m_engine->main_loop_once();
     return -1;
   }
+  m_engine->record(Trace_event {Trace_event::Type::set_cursor, 0, {}, pos});
   m_engine->cursor_pos(pos);
   return 0;
 }
@@ -111,27 +152,61 @@ int Remotemo::pause(int pause_in_ms)
   if (pause_in_ms < 0) {
     return -1;
   }
+  m_engine->record(Trace_event {
+      Trace_event::Type::pause, 0, {}, {0, 0}, pause_in_ms});
   m_engine->delay(pause_in_ms);
   return 0;
 }
 
 void Remotemo::clear(Do_reset do_reset)
 {
-  auto old_cursor_pos = m_engine->cursor_pos();
-  m_engine->clear_screen();
-  if (do_reset == Do_reset::inverse || do_reset == Do_reset::all) {
-    set_inverse(false);
+  m_engine->record(Trace_event {
+      Trace_event::Type::clear, 0, {}, {0, 0}, static_cast<int>(do_reset)});
+  m_engine->clear_screen(do_reset);
+}
+
+Key Remotemo::get_key()
+{
+  auto key = m_engine->get_key();
+  m_engine->record(Trace_event {
+      Trace_event::Type::key, 0, {}, {0, 0}, static_cast<int>(key)});
+  return key;
+}
+
+int Remotemo::run(const std::function<bool(const Run_step&)>& update_fn,
+    int steps_per_second)
+{
+  constexpr int max_steps_per_second {1000};
+  if (steps_per_second < 1 || steps_per_second > max_steps_per_second) {
+    return -1;
   }
-  if (do_reset == Do_reset::cursor || do_reset == Do_reset::all) {
-    set_cursor(0, 0);
-  } else {
-    set_cursor(old_cursor_pos);
+  constexpr double ms_per_second {1000.0};
+  m_engine->run(update_fn, ms_per_second / steps_per_second);
+  return 0;
+}
+
+int Remotemo::schedule(int delay_in_ms, std::function<void()> task_fn)
+{
+  if (delay_in_ms < 0) {
+    return -1;
   }
+  m_engine->schedule_after(delay_in_ms, std::move(task_fn));
+  return 0;
 }
 
-Key Remotemo::get_key()
+void Remotemo::schedule_on_key(std::function<void(Key)> task_fn)
+{
+  m_engine->schedule_on_key(std::move(task_fn));
+}
+
+int Remotemo::run_scheduled()
 {
-  return m_engine->get_key();
+  return m_engine->run_scheduled() ? 0 : -1;
+}
+
+void Remotemo::cancel_scheduled()
+{
+  m_engine->cancel_scheduled();
 }
 
 std::string Remotemo::get_input([[maybe_unused]] int max_length)
@@ -145,7 +220,8 @@ std::string Remotemo::get_input([[maybe_unused]] int max_length)
 int Remotemo::print(const std::string& text)
 {
   // TODO Implement wrap being set to 'word'
-  if (!m_engine->display_string_at_cursor(text, m_text_wrapping)) {
+  m_engine->record(Trace_event {Trace_event::Type::print, 0, text});
+  if (!m_engine->display_string_at_cursor(text)) {
     return -2;
   }
   return 0;
@@ -160,6 +236,25 @@ int Remotemo::print_at(const Point& pos, const std::string& text)
   return print(text);
 }
 
+int Remotemo::print_stream(std::istream& input)
+{
+  if (!m_engine->display_stream(input)) {
+    return -2;
+  }
+  return input.bad() ? -1 : 0;
+}
+
+int Remotemo::print_file(const std::string& file_path)
+{
+  std::ifstream file {file_path, std::ios::binary};
+  if (!file) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+        "Could not open '%s' for printing it\n", file_path.c_str());
+    return -1;
+  }
+  return print_stream(file);
+}
+
 char Remotemo::get_char_at(const Point& pos) const
 {
   auto area_size = m_engine->text_area_size();
@@ -172,6 +267,18 @@ char Remotemo::get_char_at(const Point& pos) const
   return m_engine->char_at(pos);
 }
 
+char32_t Remotemo::get_code_point_at(const Point& pos) const
+{
+  auto area_size = m_engine->text_area_size();
+  if (pos.x < 0 || pos.x >= area_size.width ||
+      // NOTE Although the cursor is allowed to be one line below the screen,
+      // there is no content there.
+      pos.y < 0 || pos.y > area_size.height) {
+    return 0;
+  }
+  return m_engine->code_point_at(pos);
+}
+
 bool Remotemo::is_inverse_at(const Point& pos) const
 {
   auto area_size = m_engine->text_area_size();
@@ -189,6 +296,8 @@ bool Remotemo::set_text_delay(int delay_in_ms)
   if (delay_in_ms < 0) {
     return false;
   }
+  m_engine->record(Trace_event {
+      Trace_event::Type::text_delay, 0, {}, {0, 0}, delay_in_ms});
   m_engine->delay_between_chars_ms(delay_in_ms);
   return true;
 }
@@ -213,8 +322,22 @@ double Remotemo::get_text_speed() const
   return ms_per_second / get_text_delay();
 }
 
+void Remotemo::set_escape_sequences(bool is_parsing)
+{
+  m_engine->record(Trace_event {Trace_event::Type::escape_sequences, 0, {},
+      {0, 0}, is_parsing ? 1 : 0});
+  m_engine->is_parsing_escapes(is_parsing);
+}
+
+bool Remotemo::get_escape_sequences() const
+{
+  return m_engine->is_parsing_escapes();
+}
+
 void Remotemo::set_inverse(bool inverse)
 {
+  m_engine->record(Trace_event {
+      Trace_event::Type::set_inverse, 0, {}, {0, 0}, inverse ? 1 : 0});
   m_engine->is_output_inversed(inverse);
 }
 
@@ -223,8 +346,137 @@ bool Remotemo::get_inverse() const
   return m_engine->is_output_inversed();
 }
 
+std::optional<Startup_timings> Remotemo::startup_timings() const
+{
+  return m_engine->startup_timings();
+}
+
+std::optional<Renderer_info> Remotemo::renderer_info() const
+{
+  return m_engine->renderer_info();
+}
+
+Render_stats Remotemo::stats() const
+{
+  return m_engine->stats();
+}
+
+void Remotemo::reset_stats()
+{
+  m_engine->reset_stats();
+}
+
+int Remotemo::set_view_position(const Point& position)
+{
+  m_engine->record(
+      Trace_event {Trace_event::Type::view_position, 0, {}, position});
+  return m_engine->view_position(position) ? 0 : -1;
+}
+
+Point Remotemo::get_view_position() const
+{
+  return m_engine->view_position();
+}
+
+int Remotemo::set_scrollback_view(int lines_back)
+{
+  m_engine->record(Trace_event {
+      Trace_event::Type::scrollback_view, 0, {}, {0, 0}, lines_back});
+  return m_engine->view_offset(lines_back) ? 0 : -1;
+}
+
+int Remotemo::get_scrollback_view() const
+{
+  return m_engine->view_offset();
+}
+
+int Remotemo::get_scrollback_size() const
+{
+  return m_engine->scrollback_size();
+}
+
+int Remotemo::replay(const std::string& trace_file, Replay_speed speed)
+{
+  auto reader = Trace_reader::create(trace_file);
+  if (!reader) {
+    return -1;
+  }
+  // What gets replayed has already been recorded once, so it does not get
+  // recorded again (nor does the text delay set here for the replay):
+  const Recording_pause recording_pause {m_engine.get()};
+  // Whatever delays the trace sets, the one set before is kept afterwards:
+  const Text_delay_keeper text_delay_keeper {m_engine.get()};
+  const bool is_original_speed = (speed == Replay_speed::original);
+  if (!is_original_speed) {
+    set_text_delay(0);
+  }
+  constexpr double us_per_ms = 1000.0;
+  const auto start_ms = m_engine->now_ms();
+  while (auto event = reader->next()) {
+    if (is_original_speed) {
+      auto wait_ms = static_cast<double>(event->time_us) / us_per_ms -
+                     (m_engine->now_ms() - start_ms);
+      if (wait_ms >= 1.0) {
+        m_engine->delay(static_cast<int>(wait_ms));
+      }
+    }
+    switch (event->type) {
+      case Trace_event::Type::print:
+        print(event->text);
+        break;
+      case Trace_event::Type::set_cursor:
+        set_cursor(event->pos);
+        break;
+      case Trace_event::Type::set_inverse:
+        set_inverse(event->value != 0);
+        break;
+      case Trace_event::Type::escape_sequences:
+        set_escape_sequences(event->value != 0);
+        break;
+      case Trace_event::Type::scrolling:
+        set_scrolling(event->value != 0);
+        break;
+      case Trace_event::Type::wrapping:
+        set_wrapping(static_cast<Wrapping>(event->value));
+        break;
+      case Trace_event::Type::view_position:
+        set_view_position(event->pos);
+        break;
+      case Trace_event::Type::scrollback_view:
+        set_scrollback_view(event->value);
+        break;
+      case Trace_event::Type::clear:
+        clear(static_cast<Do_reset>(event->value));
+        break;
+      case Trace_event::Type::text_delay:
+        if (is_original_speed) {
+          set_text_delay(event->value);
+        }
+        break;
+      case Trace_event::Type::pause:
+        if (is_original_speed) {
+          pause(event->value);
+        }
+        break;
+      case Trace_event::Type::key:
+        // The key was what the program was waiting for. Waiting until the
+        // time of the next event is all that is needed to replay that.
+        break;
+    }
+  }
+  m_engine->main_loop_once();
+  return reader->is_malformed() ? -2 : 0;
+}
+
+Handle Remotemo::handle() const
+{
+  return Handle {m_engine->command_queue()};
+}
+
 void Remotemo::set_scrolling(bool is_scrolling)
 {
+  m_engine->record(Trace_event {
+      Trace_event::Type::scrolling, 0, {}, {0, 0}, is_scrolling ? 1 : 0});
   m_engine->is_scrolling_allowed(is_scrolling);
 }
 
@@ -233,9 +485,16 @@ bool Remotemo::get_scrolling() const
   return m_engine->is_scrolling_allowed();
 }
 
+Wrapping Remotemo::get_wrapping() const
+{
+  return m_engine->text_wrapping();
+}
+
 void Remotemo::set_wrapping(Wrapping wrapping)
 {
-  m_text_wrapping = wrapping;
+  m_engine->record(Trace_event {Trace_event::Type::wrapping, 0, {}, {0, 0},
+      static_cast<int>(wrapping)});
+  m_engine->text_wrapping(wrapping);
   if (wrapping == Wrapping::word) {
     SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
         "Wrapping whole words not implemented yet. "
@@ -243,4 +502,40 @@ void Remotemo::set_wrapping(Wrapping wrapping)
   }
 }
 
+void Handle::print(const std::string& text) const
+{
+  if (auto command_queue = m_command_queue.lock()) {
+    command_queue->push(Command {Command::Type::print, text});
+  }
+}
+
+void Handle::set_cursor(const Point& position) const
+{
+  if (auto command_queue = m_command_queue.lock()) {
+    command_queue->push(Command {Command::Type::set_cursor, {}, position});
+  }
+}
+
+void Handle::set_inverse(bool inverse) const
+{
+  if (auto command_queue = m_command_queue.lock()) {
+    command_queue->push(
+        Command {Command::Type::set_inverse, {}, {0, 0}, inverse});
+  }
+}
+
+void Handle::clear(Do_reset do_reset) const
+{
+  if (auto command_queue = m_command_queue.lock()) {
+    command_queue->push(
+        Command {Command::Type::clear, {}, {0, 0}, false, do_reset});
+  }
+}
+
+void Handle::skip_animation() const
+{
+  if (auto command_queue = m_command_queue.lock()) {
+    command_queue->request_skip();
+  }
+}
 } // namespace remotemo
@@ -1,27 +1,65 @@
 #include "renderer.hpp"
 
 namespace remotemo {
-std::optional<Renderer> Renderer::create(
-    SDL_Window* window, Res_handler<SDL_Renderer>&& res_handler)
+std::optional<Renderer> Renderer::create(SDL_Window* window,
+    Res_handler<SDL_Renderer>&& res_handler,
+    const Renderer_config& renderer_config)
 {
   Renderer renderer {std::move(res_handler)};
   if (renderer.res() == nullptr) {
-    if (!renderer.setup(window)) {
+    if (!renderer.setup(window, renderer_config)) {
       return {};
     }
   }
   return renderer;
 }
 
-bool Renderer::setup(SDL_Window* window)
+bool Renderer::setup(
+    SDL_Window* window, const Renderer_config& renderer_config)
 {
-  res(::SDL_CreateRenderer(window, -1, SDL_RENDERER_TARGETTEXTURE));
+  if (!renderer_config.driver.empty() &&
+      ::SDL_SetHint(SDL_HINT_RENDER_DRIVER, renderer_config.driver.c_str()) ==
+          SDL_FALSE) {
+    ::SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+        "SDL_SetHint() (render driver to %s) failed: %s\n",
+        renderer_config.driver.c_str(), ::SDL_GetError());
+  }
+  Uint32 flags {0};
+  switch (renderer_config.acceleration) {
+    case Renderer_acceleration::accelerated:
+      flags |= SDL_RENDERER_ACCELERATED;
+      break;
+    case Renderer_acceleration::software:
+      flags |= SDL_RENDERER_SOFTWARE;
+      break;
+    default:
+      break;
+  }
+  if (renderer_config.is_vsync) {
+    flags |= SDL_RENDERER_PRESENTVSYNC;
+  }
+  if (renderer_config.is_target_texture_required) {
+    flags |= SDL_RENDERER_TARGETTEXTURE;
+  }
+  res(::SDL_CreateRenderer(window, -1, flags));
   if (res() == nullptr) {
     ::SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
         "SDL_CreateRenderer() failed: %s\n", ::SDL_GetError());
     return false;
   }
   is_owned(true);
+  if (!renderer_config.is_target_texture_required) {
+    // Then it still has to be checked:
+    SDL_RendererInfo info {};
+    if (::SDL_GetRendererInfo(res(), &info) != 0 ||
+        (info.flags & SDL_RENDERER_TARGETTEXTURE) == 0) {
+      ::SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
+          "The renderer created (%s) does not support rendering to a "
+          "texture\n",
+          info.name == nullptr ? "unknown" : info.name);
+      return false;
+    }
+  }
   return true;
 }
 } // namespace remotemo
@@ -21,11 +21,12 @@ public:
       : Res_handler<SDL_Renderer>(std::move(res_handler))
   {}
 
-  static std::optional<Renderer> create(
-      SDL_Window* window, Res_handler<SDL_Renderer>&& res_handler);
+  static std::optional<Renderer> create(SDL_Window* window,
+      Res_handler<SDL_Renderer>&& res_handler,
+      const Renderer_config& renderer_config);
 
 private:
-  bool setup(SDL_Window* window);
+  bool setup(SDL_Window* window, const Renderer_config& renderer_config);
 };
 } // namespace remotemo
 #endif // REMOTEMO_SRC_RENDERER_HPP
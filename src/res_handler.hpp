@@ -29,6 +29,7 @@ private:
   void destroy_res(SDL_Window* window) { SDL_DestroyWindow(window); }
   void destroy_res(SDL_Renderer* renderer) { SDL_DestroyRenderer(renderer); }
   void destroy_res(SDL_Texture* texture) { SDL_DestroyTexture(texture); }
+  void destroy_res(SDL_Surface* surface) { SDL_FreeSurface(surface); }
 
   T* m_resource {nullptr};
   bool m_is_owned {false};
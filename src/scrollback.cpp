@@ -0,0 +1,37 @@
+#include "scrollback.hpp"
+
+#include <cstddef>
+
+namespace remotemo {
+Scrollback::Scrollback(int capacity, int columns)
+    : m_capacity(capacity > 0 && columns > 0 ? capacity : 0),
+      m_columns(columns),
+      m_squares(static_cast<std::size_t>(m_capacity) * m_columns)
+{}
+
+void Scrollback::push(const std::vector<Display_square>& line)
+{
+  if (m_capacity == 0) {
+    return;
+  }
+  auto* squares = &m_squares[static_cast<std::size_t>(m_next) * m_columns];
+  for (int column = 0; column < m_columns; column++) {
+    const auto& square = line[column];
+    squares[column] = static_cast<std::uint16_t>(
+        square.glyph | (square.is_inversed ? inverse_bit : 0U));
+  }
+  m_next = (m_next + 1) % m_capacity;
+  if (m_size < m_capacity) {
+    m_size++;
+  }
+}
+
+Display_square Scrollback::square_at(int line, int column) const
+{
+  auto index = (m_next - 1 - line + m_capacity) % m_capacity;
+  auto square =
+      m_squares[static_cast<std::size_t>(index) * m_columns + column];
+  return Display_square {static_cast<Glyph>(square & ~inverse_bit),
+      (square & inverse_bit) != 0};
+}
+} // namespace remotemo
@@ -0,0 +1,37 @@
+#ifndef REMOTEMO_SRC_SCROLLBACK_HPP
+#define REMOTEMO_SRC_SCROLLBACK_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "display_square.hpp"
+
+namespace remotemo {
+// The lines that have been scrolled off the top of the text area, kept in a
+// ring of fixed capacity (so that once it is full, the oldest line gets
+// overwritten). All the memory is allocated up front, two bytes per square:
+// there are far fewer glyphs than that can count, so the highest bit is free
+// to store is_inversed.
+class Scrollback {
+public:
+  Scrollback(int capacity, int columns);
+
+  [[nodiscard]] int capacity() const { return m_capacity; }
+  // Number of lines currently kept.
+  [[nodiscard]] int size() const { return m_size; }
+  void push(const std::vector<Display_square>& line);
+  // Line 0 is the newest one (i.e. the one that was scrolled off last).
+  [[nodiscard]] Display_square square_at(int line, int column) const;
+
+private:
+  static constexpr std::uint16_t inverse_bit {0x8000};
+
+  int m_capacity;
+  int m_columns;
+  std::vector<std::uint16_t> m_squares;
+  // Index of the line that the next push will write to:
+  int m_next {0};
+  int m_size {0};
+};
+} // namespace remotemo
+#endif // REMOTEMO_SRC_SCROLLBACK_HPP
@@ -0,0 +1,177 @@
+#include "session_trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace remotemo {
+namespace {
+constexpr std::array<char, 4> trace_magic {'R', 'M', 'T', 'R'};
+constexpr char trace_version {1};
+// Long enough for any Uint64:
+constexpr int max_varint_bytes {10};
+constexpr unsigned varint_data_bits {7};
+constexpr Uint8 varint_data_mask {0x7f};
+constexpr Uint8 varint_more_bit {0x80};
+// Anything longer is taken as a sign of a malformed trace file:
+constexpr Uint64 max_print_length {Uint64 {1} << 24U};
+
+void write_varint(std::ofstream* file, Uint64 value)
+{
+  while (value >= varint_more_bit) {
+    file->put(
+        static_cast<char>((value & varint_data_mask) | varint_more_bit));
+    value >>= varint_data_bits;
+  }
+  file->put(static_cast<char>(value));
+}
+
+void write_varint(std::ofstream* file, int value)
+{
+  // None of the recorded values can be negative:
+  write_varint(file, static_cast<Uint64>(value < 0 ? 0 : value));
+}
+} // namespace
+
+std::optional<Session_recorder> Session_recorder::create(
+    const std::string& file_path)
+{
+  std::ofstream file {file_path, std::ios::binary | std::ios::trunc};
+  if (!file) {
+    SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
+        "Could not open '%s' for recording the session\n", file_path.c_str());
+    return {};
+  }
+  file.write(trace_magic.data(), trace_magic.size());
+  file.put(trace_version);
+  return Session_recorder {std::move(file)};
+}
+
+void Session_recorder::record(Trace_event&& event)
+{
+  // The clock never goes backwards, but rounding might:
+  auto time_us = std::max(event.time_us, m_last_time_us);
+  m_file.put(static_cast<char>(event.type));
+  write_varint(&m_file, time_us - m_last_time_us);
+  m_last_time_us = time_us;
+  switch (event.type) {
+    case Trace_event::Type::print:
+      write_varint(&m_file, static_cast<Uint64>(event.text.size()));
+      m_file.write(event.text.data(),
+          static_cast<std::streamsize>(event.text.size()));
+      break;
+    case Trace_event::Type::set_cursor:
+    case Trace_event::Type::view_position:
+      write_varint(&m_file, event.pos.x);
+      write_varint(&m_file, event.pos.y);
+      break;
+    case Trace_event::Type::key:
+      write_varint(&m_file, event.value);
+      // The user is waiting for the program anyway, so this is a good time
+      // to make sure that what has been recorded so far is not lost:
+      m_file.flush();
+      break;
+    default:
+      write_varint(&m_file, event.value);
+      break;
+  }
+}
+
+std::optional<Trace_reader> Trace_reader::create(const std::string& file_path)
+{
+  std::ifstream file {file_path, std::ios::binary};
+  if (!file) {
+    SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
+        "Could not open the trace file '%s'\n", file_path.c_str());
+    return {};
+  }
+  std::array<char, trace_magic.size() + 1> header {};
+  if (!file.read(header.data(), header.size()) ||
+      !std::equal(trace_magic.begin(), trace_magic.end(), header.begin()) ||
+      header.back() != trace_version) {
+    SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
+        "'%s' is not a trace file (of a supported version)\n",
+        file_path.c_str());
+    return {};
+  }
+  return Trace_reader {std::move(file)};
+}
+
+std::optional<Uint64> Trace_reader::read_varint()
+{
+  Uint64 value {0};
+  for (int i = 0; i < max_varint_bytes; i++) {
+    auto byte = m_file.get();
+    if (byte == std::ifstream::traits_type::eof()) {
+      return {};
+    }
+    value |= static_cast<Uint64>(byte & varint_data_mask)
+             << (varint_data_bits * i);
+    if ((byte & varint_more_bit) == 0) {
+      return value;
+    }
+  }
+  return {};
+}
+
+std::optional<Trace_event> Trace_reader::next()
+{
+  if (m_is_malformed) {
+    return {};
+  }
+  auto type = m_file.get();
+  if (type == std::ifstream::traits_type::eof()) {
+    return {};
+  }
+  auto malformed = [this]() -> std::optional<Trace_event> {
+    SDL_LogCritical(
+        SDL_LOG_CATEGORY_APPLICATION, "The trace file is malformed\n");
+    m_is_malformed = true;
+    return {};
+  };
+  auto delta_us = read_varint();
+  if (!delta_us || type < static_cast<int>(Trace_event::Type::print) ||
+      type > static_cast<int>(Trace_event::Type::scrollback_view)) {
+    return malformed();
+  }
+  m_last_time_us += *delta_us;
+  Trace_event event {static_cast<Trace_event::Type>(type), m_last_time_us};
+  auto to_int = [](Uint64 value) {
+    return static_cast<int>(
+        std::min<Uint64>(value, std::numeric_limits<int>::max()));
+  };
+  switch (event.type) {
+    case Trace_event::Type::print: {
+      auto length = read_varint();
+      if (!length || *length > max_print_length) {
+        return malformed();
+      }
+      event.text.resize(static_cast<std::size_t>(*length));
+      if (!m_file.read(
+              event.text.data(), static_cast<std::streamsize>(*length))) {
+        return malformed();
+      }
+      break;
+    }
+    case Trace_event::Type::set_cursor:
+    case Trace_event::Type::view_position: {
+      auto x = read_varint();
+      auto y = read_varint();
+      if (!x || !y) {
+        return malformed();
+      }
+      event.pos = Point {to_int(*x), to_int(*y)};
+      break;
+    }
+    default: {
+      auto value = read_varint();
+      if (!value) {
+        return malformed();
+      }
+      event.value = to_int(*value);
+      break;
+    }
+  }
+  return event;
+}
+} // namespace remotemo
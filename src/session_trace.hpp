@@ -0,0 +1,84 @@
+#ifndef REMOTEMO_SRC_SESSION_TRACE_HPP
+#define REMOTEMO_SRC_SESSION_TRACE_HPP
+
+#include <fstream>
+#include <optional>
+#include <string>
+
+#include "remotemo/common_types.hpp"
+
+#include <SDL.h>
+
+namespace remotemo {
+struct Trace_event {
+  // NOTE The values get written to the trace files, so never change them.
+  enum class Type : Uint8 {
+    print = 1,
+    set_cursor = 2,
+    set_inverse = 3,
+    clear = 4,
+    key = 5,
+    text_delay = 6,
+    pause = 7,
+    escape_sequences = 8,
+    scrolling = 9,
+    wrapping = 10,
+    view_position = 11,
+    scrollback_view = 12
+  };
+
+  Type type;
+  // Microseconds since the recording started:
+  Uint64 time_us {0};
+  // Only used by 'print':
+  std::string text {};
+  // Only used by 'set_cursor' and 'view_position':
+  Point pos {0, 0};
+  // Used by the rest: 'set_inverse', 'escape_sequences' and 'scrolling' (0
+  // or 1), 'clear' (a Do_reset), 'key' (a Key), 'wrapping' (a Wrapping),
+  // 'text_delay' and 'pause' (in milliseconds) and 'scrollback_view' (in
+  // lines).
+  int value {0};
+};
+
+// A trace file starts with a header (magic and version) followed by the
+// events. Each event is a type byte, the time since the previous event (as a
+// varint, in microseconds) and then the arguments (also as varints, except
+// that the text of 'print' is its length followed by the bytes).
+class Session_recorder {
+public:
+  static std::optional<Session_recorder> create(const std::string& file_path);
+
+  // The event's time has to be set already.
+  void record(Trace_event&& event);
+
+private:
+  explicit Session_recorder(std::ofstream&& file) noexcept
+      : m_file(std::move(file))
+  {}
+
+  std::ofstream m_file;
+  Uint64 m_last_time_us {0};
+};
+
+class Trace_reader {
+public:
+  static std::optional<Trace_reader> create(const std::string& file_path);
+
+  // Returns the next event, or nothing at the end of the trace (or if it is
+  // malformed, in which case is_malformed() tells so).
+  std::optional<Trace_event> next();
+  [[nodiscard]] bool is_malformed() const { return m_is_malformed; }
+
+private:
+  explicit Trace_reader(std::ifstream&& file) noexcept
+      : m_file(std::move(file))
+  {}
+  std::optional<Uint64> read_varint();
+
+  std::ifstream m_file;
+  Uint64 m_last_time_us {0};
+  bool m_is_malformed {false};
+};
+} // namespace remotemo
+#endif // REMOTEMO_SRC_SESSION_TRACE_HPP
@@ -0,0 +1,38 @@
+#ifndef REMOTEMO_SRC_STOPWATCH_HPP
+#define REMOTEMO_SRC_STOPWATCH_HPP
+
+#include <SDL.h>
+
+namespace remotemo {
+class Stopwatch {
+public:
+  Stopwatch() noexcept
+      : m_start(::SDL_GetPerformanceCounter()), m_last_lap(m_start)
+  {}
+
+  [[nodiscard]] static double to_ms(Uint64 counter_ticks)
+  {
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
+    return static_cast<double>(counter_ticks) * 1000.0 /
+           static_cast<double>(::SDL_GetPerformanceFrequency());
+  }
+  [[nodiscard]] Uint64 start() const { return m_start; }
+  [[nodiscard]] double total_ms() const
+  {
+    return to_ms(::SDL_GetPerformanceCounter() - m_start);
+  }
+  // Time since the previous lap (or since the start, if this is the first).
+  double lap_ms()
+  {
+    auto now = ::SDL_GetPerformanceCounter();
+    auto lap = now - m_last_lap;
+    m_last_lap = now;
+    return to_ms(lap);
+  }
+
+private:
+  Uint64 m_start;
+  Uint64 m_last_lap;
+};
+} // namespace remotemo
+#endif // REMOTEMO_SRC_STOPWATCH_HPP
@@ -0,0 +1,59 @@
+#include "task_scheduler.hpp"
+
+#include <utility>
+
+namespace remotemo {
+void Task_scheduler::at(double time_ms, std::function<void()>&& task_fn)
+{
+  m_timers.push(Timer {time_ms, m_next_sequence++, std::move(task_fn)});
+}
+
+void Task_scheduler::on_key(std::function<void(Key)>&& task_fn)
+{
+  m_key_waiters.push_back(std::move(task_fn));
+}
+
+bool Task_scheduler::run_due(double now_ms)
+{
+  bool did_run_any = false;
+  // Anything the tasks schedule for now (or earlier) waits for the next
+  // time, so that a task can not keep this going forever:
+  const auto end_sequence = m_next_sequence;
+  while (!m_timers.empty() && m_timers.top().time_ms <= now_ms &&
+         m_timers.top().sequence < end_sequence) {
+    // NOTE The task might schedule more, so it has to be off the queue
+    // before it runs:
+    auto task_fn = std::move(const_cast<Timer&>(m_timers.top()) // NOLINT
+                                 .task_fn);
+    m_timers.pop();
+    task_fn();
+    did_run_any = true;
+  }
+  return did_run_any;
+}
+
+bool Task_scheduler::key_pressed(Key key)
+{
+  if (m_key_waiters.empty()) {
+    return false;
+  }
+  auto task_fn = std::move(m_key_waiters.front());
+  m_key_waiters.pop_front();
+  task_fn(key);
+  return true;
+}
+
+void Task_scheduler::clear()
+{
+  m_timers = {};
+  m_key_waiters.clear();
+}
+
+std::optional<double> Task_scheduler::next_time_ms() const
+{
+  if (m_timers.empty()) {
+    return {};
+  }
+  return m_timers.top().time_ms;
+}
+} // namespace remotemo
@@ -0,0 +1,59 @@
+#ifndef REMOTEMO_SRC_TASK_SCHEDULER_HPP
+#define REMOTEMO_SRC_TASK_SCHEDULER_HPP
+
+#include <deque>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <vector>
+
+#include "remotemo/common_types.hpp"
+
+namespace remotemo {
+// Keeps track of what is waiting either for a point in time (by the engine's
+// clock) or for a key. Everything runs on the thread that owns the engine.
+class Task_scheduler {
+public:
+  void at(double time_ms, std::function<void()>&& task_fn);
+  void on_key(std::function<void(Key)>&& task_fn);
+
+  // Runs everything that was due at (or before) now_ms, in the order it was
+  // due. Returns false if there was nothing.
+  bool run_due(double now_ms);
+  // Hands the key to the one that has waited the longest. Returns false if
+  // nobody was waiting for a key.
+  bool key_pressed(Key key);
+  // Drops everything, without running it.
+  void clear();
+
+  [[nodiscard]] std::optional<double> next_time_ms() const;
+  [[nodiscard]] bool is_waiting_for_key() const
+  {
+    return !m_key_waiters.empty();
+  }
+  [[nodiscard]] bool is_empty() const
+  {
+    return m_timers.empty() && m_key_waiters.empty();
+  }
+
+private:
+  struct Timer {
+    double time_ms;
+    // Keeps those due at the same time in the order they were scheduled:
+    Uint64 sequence;
+    std::function<void()> task_fn;
+  };
+  struct Is_later {
+    bool operator()(const Timer& a, const Timer& b) const
+    {
+      return a.time_ms > b.time_ms ||
+             (a.time_ms == b.time_ms && a.sequence > b.sequence);
+    }
+  };
+
+  std::priority_queue<Timer, std::vector<Timer>, Is_later> m_timers {};
+  std::deque<std::function<void(Key)>> m_key_waiters {};
+  Uint64 m_next_sequence {0};
+};
+} // namespace remotemo
+#endif // REMOTEMO_SRC_TASK_SCHEDULER_HPP
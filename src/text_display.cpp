@@ -1,5 +1,9 @@
 #include "text_display.hpp"
 
+#include <cstdlib>
+
+#include "utf8_decoder.hpp"
+
 namespace remotemo {
 std::optional<Text_display> Text_display::create(Font&& font,
     const Text_area_config& text_area_config, SDL_Renderer* renderer)
@@ -29,7 +33,18 @@ std::optional<Text_display> Text_display::create(Font&& font,
 
 char Text_display::char_at(const Point& pos) const
 {
-  return m_display_content[pos.y][pos.x].character;
+  auto glyph = m_display_content[pos.y][pos.x].glyph;
+  return glyph <= max_ascii_value ? static_cast<char>(glyph)
+                                  : not_ascii_symbol;
+}
+
+char32_t Text_display::code_point_at(const Point& pos) const
+{
+  auto glyph = m_display_content[pos.y][pos.x].glyph;
+  if (glyph == not_ascii_symbol) {
+    return Utf8_decoder::replacement_char;
+  }
+  return Font::code_point_of(glyph);
 }
 
 bool Text_display::is_inverse_at(const Point& pos) const
@@ -50,7 +65,7 @@ void Text_display::cursor_pos(const Point& pos)
 
 void Text_display::update_cursor()
 {
-  if (m_is_cursor_updated) {
+  if (m_is_cursor_updated || m_view_offset != 0) {
     return;
   }
   m_is_cursor_updated = true;
@@ -67,92 +82,487 @@ void Text_display::show_char_hidden_by_cursor()
     return;
   }
   auto& content_at_cursor = m_display_content[m_cursor_pos.y][m_cursor_pos.x];
-  display_char_at(content_at_cursor.character, content_at_cursor.is_inversed,
-      m_cursor_pos);
+  display_char_at(
+      content_at_cursor.glyph, content_at_cursor.is_inversed, m_cursor_pos);
 }
 
-void Text_display::set_char_at_cursor(int character)
+void Text_display::set_char_at_cursor(char32_t code_point)
 {
   if (m_cursor_pos.x >= m_columns || m_cursor_pos.y >= m_lines) {
     return;
   }
-  if (character < 0 || character > max_ascii_value) {
-    SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
-        "The character \'%c\' (%d) is not an ASCII character.\n", character,
-        character);
-    character = not_ascii_symbol;
+  auto glyph = code_point <= max_ascii_value
+                   ? std::optional<Glyph> {static_cast<Glyph>(code_point)}
+                   : m_font.glyph_of(code_point);
+  if (!glyph) {
+    if (!m_has_warned_of_missing_glyph) {
+      SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+          "The character U+%04X is not in the font, so it (and any other "
+          "such character) gets shown as a replacement.\n",
+          static_cast<unsigned>(code_point));
+      m_has_warned_of_missing_glyph = true;
+    }
+    glyph = not_ascii_symbol;
   }
+  show_live_content();
   auto& content_at_cursor = m_display_content[m_cursor_pos.y][m_cursor_pos.x];
-  content_at_cursor.character = static_cast<char>(character);
+  content_at_cursor.glyph = *glyph;
   content_at_cursor.is_inversed = m_is_output_inversed;
 }
 
+void Text_display::set_chars_at_cursor(std::string_view text)
+{
+  if (m_cursor_pos.y >= m_lines) {
+    return;
+  }
+  show_live_content();
+  auto* squares = &m_display_content[m_cursor_pos.y][m_cursor_pos.x];
+  for (std::size_t i = 0; i < text.size(); i++) {
+    squares[i] = Display_square {
+        static_cast<Glyph>(text[i]), m_is_output_inversed};
+  }
+  if (m_is_texture_refresh_needed) {
+    // All of it gets redrawn anyway.
+    return;
+  }
+  // Only the part in view gets drawn, all in one go:
+  const int view_line = m_cursor_pos.y - m_view_position.y;
+  const int first_column =
+      std::max(m_cursor_pos.x, m_view_position.x) - m_view_position.x;
+  const int run_end = m_cursor_pos.x + static_cast<int>(text.size());
+  const int end_column =
+      std::min(run_end, m_view_position.x + m_view_columns) -
+      m_view_position.x;
+  if (view_line < 0 || view_line >= m_view_lines ||
+      first_column >= end_column) {
+    return;
+  }
+  set_render_target(res());
+  const int char_width = m_font.char_width();
+  const int char_height = m_font.char_height();
+  for (int column = first_column; column < end_column; column++) {
+    auto character = text[static_cast<std::size_t>(
+        column + m_view_position.x - m_cursor_pos.x)];
+    auto source = m_font.glyph_area(
+        static_cast<Glyph>(character), m_is_output_inversed);
+    SDL_Rect target {1 + column * char_width, 1 + view_line * char_height,
+        char_width, char_height};
+    render_copy(&source, &target);
+  }
+  add_dirty_area(SDL_Rect {1 + first_column * char_width,
+      1 + view_line * char_height, (end_column - first_column) * char_width,
+      char_height});
+  m_has_texture_changed = true;
+  set_render_target(nullptr);
+}
+
 void Text_display::clear_line(int line)
 {
-  SDL_SetRenderTarget(m_renderer, res());
+  show_live_content();
+  m_display_content[line] = m_empty_line;
+  if (line == m_cursor_pos.y) {
+    m_is_cursor_updated = false;
+  }
+  auto view_line = line - m_view_position.y;
+  if (view_line < 0 || view_line >= m_view_lines) {
+    return;
+  }
+  set_render_target(res());
 
   int line_length = texture_size().width - 2;
   int line_height = m_font.char_height();
   // NOTE Following can easily be changed to take 'is_inverse' into account:
-  SDL_Rect space_bitmap = {space_position.x * m_font.char_width(),
-      space_position.y * m_font.char_height(), m_font.char_width(),
-      m_font.char_height()};
+  auto space_bitmap = m_font.glyph_area(' ', false);
   SDL_Rect target_area = {
-      1, 1 + (line * line_height), line_length, line_height};
-  SDL_RenderCopy(m_renderer, m_font.res(), &space_bitmap, &target_area);
+      1, 1 + (view_line * line_height), line_length, line_height};
+  render_copy(&space_bitmap, &target_area);
+  add_dirty_area(target_area);
 
-  m_display_content[line] = m_empty_line;
   m_has_texture_changed = true;
+  set_render_target(nullptr);
+}
+
+void Text_display::clear_part_of_line(
+    int line, int first_column, int end_column)
+{
+  show_live_content();
+  for (int column = first_column; column < end_column; column++) {
+    m_display_content[line][column] = Display_square {};
+    display_char_at(' ', false, Point {column, line});
+  }
   if (line == m_cursor_pos.y) {
     m_is_cursor_updated = false;
   }
-  SDL_SetRenderTarget(m_renderer, nullptr);
+}
+
+void Text_display::scroll_lines_up(int top, int bottom)
+{
+  show_live_content();
+  auto first = m_display_content.begin() + top;
+  std::rotate(first, first + 1, m_display_content.begin() + bottom + 1);
+  m_display_content[bottom] = m_empty_line;
+  m_is_texture_refresh_needed = true;
 }
 
 void Text_display::scroll_up_one_line()
 {
+  show_live_content();
+  m_scrollback.push(m_display_content.front());
   m_display_content.push_back(m_empty_line);
   m_display_content.pop_front();
   m_is_texture_refresh_needed = true;
 }
 
-void Text_display::refresh_texture()
+bool Text_display::view_offset(int offset)
+{
+  bool is_within_range = true;
+  if (offset < 0 || offset > m_scrollback.size()) {
+    offset = offset < 0 ? 0 : m_scrollback.size();
+    is_within_range = false;
+  }
+  if (offset != m_view_offset) {
+    m_view_offset = offset;
+    m_is_texture_refresh_needed = true;
+  }
+  return is_within_range;
+}
+
+void Text_display::show_live_content()
+{
+  // Any change to the content brings the view back to it:
+  view_offset(0);
+}
+
+void Text_display::scale_mode(SDL_ScaleMode mode)
+{
+  m_scale_mode = mode;
+  SDL_SetTextureScaleMode(res(), mode);
+  if (m_pan_texture.res() != nullptr) {
+    SDL_SetTextureScaleMode(m_pan_texture.res(), mode);
+  }
+  if (m_front_buffer.res() != nullptr) {
+    SDL_SetTextureScaleMode(m_front_buffer.res(), mode);
+  }
+}
+
+bool Text_display::view_position(const Point& pos)
+{
+  Point clamped {std::clamp(pos.x, 0, m_columns - m_view_columns),
+      std::clamp(pos.y, 0, m_lines - m_view_lines)};
+  if (clamped.x != m_view_position.x || clamped.y != m_view_position.y) {
+    if (!pan_texture(clamped)) {
+      m_view_position = clamped;
+      m_is_texture_refresh_needed = true;
+    }
+    m_is_cursor_updated = false;
+  }
+  return clamped.x == pos.x && clamped.y == pos.y;
+}
+
+bool Text_display::pan_texture(const Point& new_position)
 {
-  SDL_SetRenderTarget(m_renderer, res());
+  const Point move {new_position.x - m_view_position.x,
+      new_position.y - m_view_position.y};
+  if (m_is_texture_refresh_needed || m_view_offset != 0 ||
+      std::abs(move.x) >= m_view_columns ||
+      std::abs(move.y) >= m_view_lines) {
+    // Nothing (worth keeping) to copy.
+    return false;
+  }
+  if (m_pan_texture.res() == nullptr) {
+    m_pan_texture = create_spare_texture();
+    if (m_pan_texture.res() == nullptr) {
+      SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+          "SDL_CreateTexture() failed, so the whole view will get redrawn "
+          "when panning: %s\n",
+          ::SDL_GetError());
+      return false;
+    }
+  }
+  if (m_stale_area.w > 0) {
+    // The part that stays in view has to be up to date before copying it:
+    set_render_target(res());
+  }
+
+  // Copy the part that stays in view, as it is (i.e. without blending or
+  // coloring it), to where it will be after the move:
+  auto* old_texture = res();
+  constexpr Uint8 no_color_mod {255};
+  set_render_target(m_pan_texture.res());
   SDL_RenderClear(m_renderer);
-  for (int line = 0; line < m_lines; line++) {
-    for (int column = 0; column < m_columns; column++) {
-      auto& content = m_display_content[line][column];
-      display_char_at(
-          content.character, content.is_inversed, Point {column, line});
+  SDL_SetTextureBlendMode(old_texture, SDL_BLENDMODE_NONE);
+  SDL_SetTextureColorMod(
+      old_texture, no_color_mod, no_color_mod, no_color_mod);
+  const int char_width = m_font.char_width();
+  const int char_height = m_font.char_height();
+  const int kept_width = (m_view_columns - std::abs(move.x)) * char_width;
+  const int kept_height = (m_view_lines - std::abs(move.y)) * char_height;
+  SDL_Rect source {1 + std::max(move.x, 0) * char_width,
+      1 + std::max(move.y, 0) * char_height, kept_width, kept_height};
+  SDL_Rect target {1 + std::max(-move.x, 0) * char_width,
+      1 + std::max(-move.y, 0) * char_height, kept_width, kept_height};
+  SDL_RenderCopy(m_renderer, old_texture, &source, &target);
+  m_stats.render_copy_calls++;
+  add_dirty_area(
+      SDL_Rect {0, 0, texture_size().width, texture_size().height});
+  SDL_SetTextureBlendMode(old_texture, m_blend_mode);
+  SDL_SetTextureColorMod(
+      old_texture, m_color.red, m_color.green, m_color.blue);
+  set_render_target(nullptr);
+  // NOTE Moving a Res_handler swaps the resources, so this makes the copy
+  // the texture of the text area and the old one the spare:
+  static_cast<Res_handler<SDL_Texture>&>(*this) = std::move(m_pan_texture);
+
+  // Then only the part that came into view needs to be drawn:
+  m_view_position = new_position;
+  if (move.x != 0) {
+    draw_view_area(
+        SDL_Rect {move.x > 0 ? m_view_columns - move.x : 0, 0,
+            std::abs(move.x), m_view_lines});
+  }
+  if (move.y != 0) {
+    draw_view_area(SDL_Rect {0, move.y > 0 ? m_view_lines - move.y : 0,
+        m_view_columns, std::abs(move.y)});
+  }
+  m_has_texture_changed = true;
+  return true;
+}
+
+Res_handler<SDL_Texture> Text_display::create_spare_texture() const
+{
+  auto size = texture_size();
+  Res_handler<SDL_Texture> texture {SDL_CreateTexture(m_renderer,
+      SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, size.width,
+      size.height)};
+  if (texture.res() != nullptr) {
+    SDL_SetTextureBlendMode(texture.res(), m_blend_mode);
+    SDL_SetTextureScaleMode(texture.res(), m_scale_mode);
+    SDL_SetTextureColorMod(
+        texture.res(), m_color.red, m_color.green, m_color.blue);
+  }
+  return texture;
+}
+
+void Text_display::swap_buffers()
+{
+  if (!m_is_double_buffered) {
+    return;
+  }
+  const SDL_Rect whole_texture {
+      0, 0, texture_size().width, texture_size().height};
+  if (m_front_buffer.res() == nullptr) {
+    m_front_buffer = create_spare_texture();
+    if (m_front_buffer.res() == nullptr) {
+      SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+          "SDL_CreateTexture() failed, so the text area will not be double "
+          "buffered: %s\n",
+          ::SDL_GetError());
+      m_is_double_buffered = false;
+      return;
     }
+    // Nothing has been drawn into it yet:
+    m_stale_area = whole_texture;
+  } else if (m_dirty_area.w > 0 && m_dirty_area.h > 0) {
+    // The texture shown until now lacks what has been drawn since:
+    if (m_stale_area.w == 0 || m_stale_area.h == 0) {
+      m_stale_area = m_dirty_area;
+    } else {
+      SDL_UnionRect(&m_stale_area, &m_dirty_area, &m_stale_area);
+    }
+  }
+  // NOTE Moving a Res_handler swaps the resources:
+  static_cast<Res_handler<SDL_Texture>&>(*this) = std::move(m_front_buffer);
+}
+
+void Text_display::copy_forward()
+{
+  // Copied as it is (i.e. without blending or coloring it), the same way as
+  // when panning. The render target is already the texture drawn into.
+  auto* front = m_front_buffer.res();
+  constexpr Uint8 no_color_mod {255};
+  SDL_SetTextureBlendMode(front, SDL_BLENDMODE_NONE);
+  SDL_SetTextureColorMod(front, no_color_mod, no_color_mod, no_color_mod);
+  SDL_RenderCopy(m_renderer, front, &m_stale_area, &m_stale_area);
+  m_stats.render_copy_calls++;
+  SDL_SetTextureBlendMode(front, m_blend_mode);
+  SDL_SetTextureColorMod(front, m_color.red, m_color.green, m_color.blue);
+  m_stale_area = SDL_Rect {0, 0, 0, 0};
+}
+
+Display_square Text_display::square_in_view(const Point& view_pos) const
+{
+  Point pos {view_pos.x + m_view_position.x, view_pos.y + m_view_position.y};
+  auto scrollback_line = m_view_offset - 1 - pos.y;
+  if (scrollback_line >= 0) {
+    return m_scrollback.square_at(scrollback_line, pos.x);
   }
+  return m_display_content[pos.y - m_view_offset][pos.x];
+}
+
+void Text_display::draw_view_area(const SDL_Rect& area)
+{
+  const bool is_whole_lines = area.x == 0 && area.w == m_view_columns;
+  for (int line = area.y; line < area.y + area.h; line++) {
+    if (is_whole_lines && draw_cached_line(line)) {
+      continue;
+    }
+    for (int column = area.x; column < area.x + area.w; column++) {
+      Point view_pos {column, line};
+      auto content = square_in_view(view_pos);
+      draw_char_at(content.glyph, content.is_inversed, view_pos);
+    }
+  }
+}
+
+bool Text_display::draw_cached_line(int view_line)
+{
+  if (m_line_cache.capacity() == 0 || !has_line_atlas()) {
+    return false;
+  }
+  for (int column = 0; column < m_view_columns; column++) {
+    auto content = square_in_view(Point {column, view_line});
+    const auto index = 2 * static_cast<std::size_t>(column);
+    m_line_key[index] = static_cast<char>(content.glyph & byte_mask);
+    m_line_key[index + 1] =
+        static_cast<char>((content.glyph >> bits_per_byte) |
+                          (content.is_inversed ? inverse_key_bit : 0));
+  }
+  const int char_width = m_font.char_width();
+  const int char_height = m_font.char_height();
+  const int line_width = m_view_columns * char_width;
+  auto slot = m_line_cache.find(m_line_key);
+  if (slot) {
+    m_stats.line_cache_hits++;
+  } else {
+    m_stats.line_cache_misses++;
+    slot = m_line_cache.insert(m_line_key);
+    set_render_target(m_line_atlas.res());
+    SDL_Rect slot_area {0, *slot * char_height, line_width, char_height};
+    // Cleared first, so that the characters end up looking the same as when
+    // drawn straight onto the (cleared) texture of the text area:
+    SDL_RenderFillRect(m_renderer, &slot_area);
+    for (int column = 0; column < m_view_columns; column++) {
+      auto content = square_in_view(Point {column, view_line});
+      auto source = m_font.glyph_area(content.glyph, content.is_inversed);
+      SDL_Rect target {column * char_width, slot_area.y, char_width,
+          char_height};
+      render_copy(&source, &target);
+    }
+  }
+  set_render_target(res());
+  SDL_Rect source {0, *slot * char_height, line_width, char_height};
+  SDL_Rect target {1, 1 + view_line * char_height, line_width, char_height};
+  SDL_RenderCopy(m_renderer, m_line_atlas.res(), &source, &target);
+  m_stats.render_copy_calls++;
+  add_dirty_area(target);
+  m_has_texture_changed = true;
+  set_render_target(nullptr);
+  return true;
+}
+
+bool Text_display::has_line_atlas()
+{
+  if (m_line_atlas.res() != nullptr) {
+    return true;
+  }
+  m_line_atlas = Res_handler<SDL_Texture> {SDL_CreateTexture(m_renderer,
+      SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET,
+      m_view_columns * m_font.char_width(),
+      m_line_cache.capacity() * m_font.char_height())};
+  if (m_line_atlas.res() == nullptr) {
+    SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+        "SDL_CreateTexture() failed, so the lines will not be cached: %s\n",
+        ::SDL_GetError());
+    m_line_cache = Line_cache {0};
+    return false;
+  }
+  // The strips get copied as they are (i.e. without blending or coloring),
+  // the blending and coloring being done when the text area gets rendered:
+  SDL_SetTextureBlendMode(m_line_atlas.res(), SDL_BLENDMODE_NONE);
+  return true;
+}
+
+void Text_display::refresh_texture()
+{
+  // All of it gets redrawn anyway:
+  m_stale_area = SDL_Rect {0, 0, 0, 0};
+  set_render_target(res());
+  SDL_RenderClear(m_renderer);
+  add_dirty_area(
+      SDL_Rect {0, 0, texture_size().width, texture_size().height});
+  draw_view_area(SDL_Rect {0, 0, m_view_columns, m_view_lines});
   m_is_texture_refresh_needed = false;
   m_is_cursor_updated = false;
 }
 
+void Text_display::drop_drawn_content()
+{
+  m_pan_texture = Res_handler<SDL_Texture> {};
+  m_front_buffer = Res_handler<SDL_Texture> {};
+  m_stale_area = SDL_Rect {0, 0, 0, 0};
+  m_line_atlas = Res_handler<SDL_Texture> {};
+  m_line_cache.clear();
+  m_is_texture_refresh_needed = true;
+}
+
 void Text_display::display_char_at(
-    int character, bool is_output_inversed, const Point& pos)
+    Glyph glyph, bool is_output_inversed, const Point& pos)
 {
-  if (pos.x >= m_columns || pos.y >= m_lines) {
+  // Only what is in the view gets drawn, and while the view is scrolled back
+  // it only shows the scrollback (and the top of the text area):
+  Point view_pos {pos.x - m_view_position.x, pos.y - m_view_position.y};
+  if (view_pos.x < 0 || view_pos.x >= m_view_columns || view_pos.y < 0 ||
+      view_pos.y >= m_view_lines || m_view_offset != 0) {
     return;
   }
-  SDL_SetRenderTarget(m_renderer, res());
+  draw_char_at(glyph, is_output_inversed, view_pos);
+}
+
+void Text_display::draw_char_at(
+    Glyph glyph, bool is_output_inversed, const Point& pos)
+{
+  set_render_target(res());
   SDL_Rect display_target_area {1 + pos.x * m_font.char_width(),
       1 + pos.y * m_font.char_height(), m_font.char_width(),
       m_font.char_height()};
-  int bitmap_char_column = character % bitmap_char_per_line;
-  int bitmap_char_line = character / bitmap_char_per_line;
-  if (is_output_inversed) {
-    bitmap_char_line += bitmap_lines_per_mode;
-  }
-  SDL_Rect bitmap_char_area {bitmap_char_column * m_font.char_width(),
-      bitmap_char_line * m_font.char_height(), m_font.char_width(),
-      m_font.char_height()};
-  SDL_RenderCopy(
-      m_renderer, m_font.res(), &bitmap_char_area, &display_target_area);
+  auto bitmap_char_area = m_font.glyph_area(glyph, is_output_inversed);
+  render_copy(&bitmap_char_area, &display_target_area);
+  add_dirty_area(display_target_area);
   m_has_texture_changed = true;
-  SDL_SetRenderTarget(m_renderer, nullptr);
+  set_render_target(nullptr);
+}
+
+void Text_display::add_dirty_area(const SDL_Rect& area)
+{
+  if (m_dirty_area.w == 0 || m_dirty_area.h == 0) {
+    m_dirty_area = area;
+  } else {
+    SDL_UnionRect(&m_dirty_area, &area, &m_dirty_area);
+  }
+}
+
+void Text_display::set_render_target(SDL_Texture* texture)
+{
+  if (texture != nullptr) {
+    // About to draw, which might be with the inversed glyphs:
+    m_font.add_inverse_if_missing(m_renderer);
+  }
+  SDL_SetRenderTarget(m_renderer, texture);
+  m_stats.render_target_switches++;
+  // When double buffered, the texture drawn into gets brought up to date
+  // only when about to draw into it, rather than right after the swap, to
+  // not hold up the rendering of the frame just swapped in:
+  if (texture != nullptr && texture == res() && m_stale_area.w > 0 &&
+      m_stale_area.h > 0) {
+    copy_forward();
+  }
+}
+
+void Text_display::render_copy(
+    const SDL_Rect* src_rect, const SDL_Rect* dst_rect)
+{
+  SDL_RenderCopy(m_renderer, m_font.res(), src_rect, dst_rect);
+  m_stats.render_copy_calls++;
 }
 
 } // namespace remotemo
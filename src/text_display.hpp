@@ -1,7 +1,9 @@
 #ifndef REMOTEMO_SRC_TEXT_DISPLAY_HPP
 #define REMOTEMO_SRC_TEXT_DISPLAY_HPP
 
+#include <algorithm>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <optional>
 #include <deque>
@@ -10,21 +12,30 @@
 #include "remotemo/config.hpp"
 #include "texture.hpp"
 #include "font.hpp"
+#include "scrollback.hpp"
+#include "line_cache.hpp"
 #include <SDL.h>
 
 namespace remotemo {
-struct Display_square {
-  char character {' '};
-  bool is_inversed {false};
-};
-
 class Text_display : public Texture {
 public:
   Text_display(Font&& font, SDL_Texture* texture, SDL_Renderer* renderer,
       const Text_area_config& text_area_config) noexcept
       : Texture(texture, true), m_renderer(renderer), m_font(std::move(font)),
-        m_columns(text_area_config.columns), m_lines(text_area_config.lines),
-        m_empty_line(m_columns), m_display_content(m_lines, m_empty_line)
+        m_columns(std::max(
+            text_area_config.canvas_columns, text_area_config.columns)),
+        m_lines(
+            std::max(text_area_config.canvas_lines, text_area_config.lines)),
+        m_view_columns(text_area_config.columns),
+        m_view_lines(text_area_config.lines), m_empty_line(m_columns),
+        m_display_content(m_lines, m_empty_line),
+        m_scrollback(text_area_config.scrollback_lines, m_columns),
+        m_blend_mode(text_area_config.blend_mode),
+        m_color(text_area_config.color),
+        m_line_cache(std::min(text_area_config.line_cache_lines,
+            max_line_atlas_height / std::max(m_font.char_height(), 1))),
+        m_line_key(2 * static_cast<std::size_t>(m_view_columns), '\0'),
+        m_is_double_buffered(text_area_config.is_double_buffered)
   {}
 
   static std::optional<Text_display> create(Font&& font,
@@ -32,8 +43,21 @@ public:
   [[nodiscard]] const Font& font() const { return m_font; }
   [[nodiscard]] int columns() const { return m_columns; }
   [[nodiscard]] int lines() const { return m_lines; }
+  // The part of the text area (the canvas) that is shown:
+  [[nodiscard]] int view_columns() const { return m_view_columns; }
+  [[nodiscard]] int view_lines() const { return m_view_lines; }
+  [[nodiscard]] Point view_position() const { return m_view_position; }
+  // Clamps the position so that the view stays within the canvas. Returns
+  // false if it had to.
+  bool view_position(const Point& pos);
+  // Also used for any texture created later on (e.g. for panning):
+  void scale_mode(SDL_ScaleMode mode);
   [[nodiscard]] Point cursor_pos() const { return m_cursor_pos; }
+  // Any character that is not ASCII gives not_ascii_symbol.
   [[nodiscard]] char char_at(const Point& pos) const;
+  // Any character shown as not_ascii_symbol (i.e. not in the font) gives
+  // Utf8_decoder::replacement_char.
+  [[nodiscard]] char32_t code_point_at(const Point& pos) const;
   [[nodiscard]] bool is_inverse_at(const Point& pos) const;
   void cursor_pos(const Point& pos);
   void update_cursor();
@@ -43,10 +67,43 @@ public:
   {
     return m_is_output_inversed;
   }
-  void set_char_at_cursor(int character);
+  void set_char_at_cursor(char32_t code_point);
+  // The same as set_char_at_cursor() for each of the characters, which all
+  // have to be printable ASCII characters, and fit on the line (from the
+  // cursor on). The cursor does not move.
+  void set_chars_at_cursor(std::string_view text);
   void scroll_up_one_line();
+  [[nodiscard]] int scrollback_size() const { return m_scrollback.size(); }
+  [[nodiscard]] int scrollback_capacity() const
+  {
+    return m_scrollback.capacity();
+  }
+  // Number of lines, back into the scrollback, the view is scrolled (0 when
+  // showing the text area as it is).
+  [[nodiscard]] int view_offset() const { return m_view_offset; }
+  // Clamps the offset to what is available. Returns false if it had to.
+  bool view_offset(int offset);
   void clear_line(int line);
+  // Clears the columns from first_column up to (but not including)
+  // end_column. Like clear_line(), the blanks are never inversed, whatever
+  // is_output_inversed() is.
+  void clear_part_of_line(int line, int first_column, int end_column);
+  // Moves the lines from top + 1 to bottom (inclusive) up one line, leaving
+  // the bottom one empty. Nothing gets added to the scrollback.
+  void scroll_lines_up(int top, int bottom);
   void refresh_texture();
+  // For when the render targets (or the whole renderer) have been reset:
+  // what had been drawn into the textures is gone. The spare textures and
+  // the line atlas get dropped (and created again when needed), and the
+  // texture of the text area gets redrawn before it is next shown.
+  void drop_drawn_content();
+  // When double buffered, makes what has been drawn the texture to show,
+  // and starts drawing into the other one. Otherwise does nothing.
+  void swap_buffers();
+  [[nodiscard]] SDL_Texture* shown_texture() const
+  {
+    return m_front_buffer.res() != nullptr ? m_front_buffer.res() : res();
+  }
   void set_texture_refresh_needed(bool refresh_needed)
   {
     m_is_texture_refresh_needed = refresh_needed;
@@ -58,34 +115,82 @@ public:
   void set_texture_changed(bool has_changed)
   {
     m_has_texture_changed = has_changed;
+    if (!has_changed) {
+      m_dirty_area = SDL_Rect {0, 0, 0, 0};
+    }
   }
+  // The part of the texture (in pixels) changed since it was last marked as
+  // unchanged.
+  [[nodiscard]] const SDL_Rect& dirty_area() const { return m_dirty_area; }
   [[nodiscard]] bool has_texture_changed() const
   {
     return m_has_texture_changed;
   }
+  [[nodiscard]] const Render_stats& stats() const { return m_stats; }
+  void reset_stats() { m_stats = Render_stats {}; }
 
 private:
-  void display_char_at(
-      int character, bool is_output_inverse, const Point& pos);
+  void display_char_at(Glyph glyph, bool is_output_inverse, const Point& pos);
+  void draw_char_at(Glyph glyph, bool is_output_inverse, const Point& pos);
+  [[nodiscard]] Display_square square_in_view(const Point& view_pos) const;
+  void draw_view_area(const SDL_Rect& area);
+  bool draw_cached_line(int view_line);
+  bool has_line_atlas();
+  bool pan_texture(const Point& new_position);
+  [[nodiscard]] Res_handler<SDL_Texture> create_spare_texture() const;
+  void copy_forward();
+  void show_live_content();
+  void add_dirty_area(const SDL_Rect& area);
+  void set_render_target(SDL_Texture* texture);
+  void render_copy(const SDL_Rect* src_rect, const SDL_Rect* dst_rect);
 
   SDL_Renderer* m_renderer;
   Font m_font;
   int m_columns;
   int m_lines;
+  int m_view_columns;
+  int m_view_lines;
   std::vector<Display_square> m_empty_line;
   std::deque<std::vector<Display_square>> m_display_content;
+  Scrollback m_scrollback;
+  int m_view_offset {0};
+  Point m_view_position {0, 0};
+  SDL_BlendMode m_blend_mode;
+  SDL_ScaleMode m_scale_mode {SDL_ScaleModeLinear};
+  Color m_color;
+  // Used when panning, to copy the part of the texture that stays visible.
+  // Created the first time it is needed.
+  Res_handler<SDL_Texture> m_pan_texture {};
+  // Lines already drawn, each in its own slot (one line high) of the atlas.
+  // The atlas gets created the first time it is needed.
+  Line_cache m_line_cache;
+  Res_handler<SDL_Texture> m_line_atlas {};
+  // Kept, to not allocate each time a line gets looked up:
+  std::string m_line_key;
+  // When double buffered, res() is the texture drawn into and this the one
+  // shown. The stale area is the part of res() that has not yet been copied
+  // from it (see set_render_target()).
+  bool m_is_double_buffered;
+  Res_handler<SDL_Texture> m_front_buffer {};
+  SDL_Rect m_stale_area {0, 0, 0, 0};
   Point m_cursor_pos {0, 0};
   bool m_is_cursor_visible {true};
   bool m_is_cursor_updated {false};
   bool m_is_output_inversed {false};
+  // Only the first character missing from the font gets logged:
+  bool m_has_warned_of_missing_glyph {false};
   bool m_is_texture_refresh_needed {false};
   bool m_has_texture_changed {false};
-  static constexpr int max_ascii_value {127};
-  static constexpr int bitmap_char_per_line {16};
-  static constexpr Point space_position {0, 2};
-  static constexpr int bitmap_lines_per_mode {8};
+  SDL_Rect m_dirty_area {0, 0, 0, 0};
+  // Only the counters that concern the text area are used:
+  Render_stats m_stats {};
+  static constexpr char32_t max_ascii_value {127};
   static constexpr char not_ascii_symbol {1};
-  static constexpr char cursor_symbol {0};
+  static constexpr Glyph cursor_symbol {0};
+  static constexpr unsigned char byte_mask {0xff};
+  static constexpr int bits_per_byte {8};
+  static constexpr int inverse_key_bit {0x80};
+  static constexpr int max_line_atlas_height {8192};
 };
 } // namespace remotemo
 #endif // REMOTEMO_SRC_TEXT_DISPLAY_HPP
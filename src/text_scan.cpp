@@ -0,0 +1,78 @@
+#include "text_scan.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define REMOTEMO_USE_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace remotemo {
+namespace {
+constexpr char last_control_char {0x1f};
+
+bool is_printable(char character)
+{
+  // As signed, anything not ASCII is negative:
+  return static_cast<signed char>(character) > last_control_char;
+}
+
+#if defined(__AVX2__) || defined(REMOTEMO_USE_SSE2)
+// Index of the lowest bit set (which there has to be).
+std::size_t lowest_bit_set(unsigned mask)
+{
+#if defined(_MSC_VER)
+  unsigned long index {0}; // NOLINT(google-runtime-int)
+  _BitScanForward(&index, mask);
+  return index;
+#else
+  return static_cast<std::size_t>(__builtin_ctz(mask));
+#endif
+}
+#endif
+} // namespace
+
+std::size_t printable_run_length(std::string_view text)
+{
+  const char* data = text.data();
+  const std::size_t length = text.size();
+  std::size_t index {0};
+#if defined(__AVX2__)
+  constexpr std::size_t block_size {32};
+  const auto control_chars = _mm256_set1_epi8(last_control_char);
+  for (; index + block_size <= length; index += block_size) {
+    const auto block = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(data + index)); // NOLINT
+    // Signed comparison, so anything not ASCII fails it as well:
+    const auto is_printable_mask = static_cast<unsigned>(
+        _mm256_movemask_epi8(_mm256_cmpgt_epi8(block, control_chars)));
+    if (is_printable_mask != ~0U) {
+      return index + lowest_bit_set(~is_printable_mask);
+    }
+  }
+#elif defined(REMOTEMO_USE_SSE2)
+  constexpr std::size_t block_size {16};
+  constexpr unsigned all_printable {0xffff};
+  const auto control_chars = _mm_set1_epi8(last_control_char);
+  for (; index + block_size <= length; index += block_size) {
+    const auto block = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(data + index)); // NOLINT
+    // Signed comparison, so anything not ASCII fails it as well:
+    const auto is_printable_mask = static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_cmpgt_epi8(block, control_chars)));
+    if (is_printable_mask != all_printable) {
+      return index + lowest_bit_set(~is_printable_mask);
+    }
+  }
+#endif
+  // What is left (or all of it, without SIMD):
+  while (index < length && is_printable(data[index])) {
+    index++;
+  }
+  return index;
+}
+} // namespace remotemo
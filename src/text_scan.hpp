@@ -0,0 +1,17 @@
+#ifndef REMOTEMO_SRC_TEXT_SCAN_HPP
+#define REMOTEMO_SRC_TEXT_SCAN_HPP
+
+#include <cstddef>
+#include <string_view>
+
+namespace remotemo {
+// Returns the number of characters at the start of the text that can be
+// put on the screen as they are, i.e. printable ASCII characters (from ' '
+// up to and including DEL). Stops at any control character (e.g. '\n' or
+// '\b') or anything that is not ASCII.
+//
+// Checks 32 (with AVX2) or 16 (with SSE2) characters at a time, if the
+// library gets built for a CPU that has them.
+std::size_t printable_run_length(std::string_view text);
+} // namespace remotemo
+#endif // REMOTEMO_SRC_TEXT_SCAN_HPP
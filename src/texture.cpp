@@ -1,5 +1,7 @@
 #include "texture.hpp"
 
+#include <system_error>
+
 #include <SDL_image.h>
 
 namespace remotemo {
@@ -8,13 +10,15 @@ namespace remotemo {
 // See https://github.com/llvm/llvm-project/issues/47384
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 std::optional<std::filesystem::path> Texture::m_base_path {};
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+bool Texture::m_is_base_path_missing {false};
 
 bool Texture::set_base_path()
 {
   char* c_base_path = ::SDL_GetBasePath();
   if (c_base_path == nullptr) {
-    ::SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
-        "SDL_GetBasePath() failed: %s\n", ::SDL_GetError());
+    // Only logged once it turns out that the path is needed, which it is not
+    // for a resource compiled into the library:
     return false;
   }
   m_base_path = c_base_path;
@@ -23,32 +27,146 @@ bool Texture::set_base_path()
   return true;
 }
 
-bool Texture::load(SDL_Renderer* renderer, const std::string& file_path)
+namespace {
+template<typename F> std::future<SDL_Surface*> decode_async(const F& decode)
+{
+  try {
+    return std::async(std::launch::async, decode);
+  } catch (const std::system_error&) {
+    // No thread to be had, so decode once the surface is asked for instead:
+    return std::async(std::launch::deferred, decode);
+  }
+}
+} // namespace
+
+Surface_loader::~Surface_loader()
+{
+  if (m_surface.valid()) {
+    auto* surface = m_surface.get();
+    if (surface != nullptr) {
+      ::SDL_FreeSurface(surface);
+    }
+  }
+}
+
+Surface_loader& Surface_loader::operator=(Surface_loader&& other) noexcept
+{
+  std::swap(m_surface, other.m_surface);
+  std::swap(m_name, other.m_name);
+  return *this;
+}
+
+Surface_loader Surface_loader::start(
+    std::function<SDL_Surface*()> make_surface, std::string name)
+{
+  return {decode_async(make_surface), std::move(name)};
+}
+
+SDL_Surface* Surface_loader::get()
+{
+  if (!m_surface.valid()) {
+    return nullptr;
+  }
+  return m_surface.get();
+}
+
+Surface_loader Texture::start_loading(const Texture_config& texture_config)
 {
-  if (!m_base_path.has_value()) {
-    if (!set_base_path()) {
-      return false;
+  if (texture_config.raw_sdl != nullptr) {
+    return {};
+  }
+  const auto& file_path = texture_config.file_path;
+  auto embedded = Embedded_res::find(file_path);
+#ifdef REMOTEMO_FILES_OVERRIDE_EMBEDDED
+  constexpr bool can_file_override {true};
+#else
+  constexpr bool can_file_override {false};
+#endif
+  std::optional<std::filesystem::path> texture_path {};
+  // Unless built to let a file (e.g. one put there to replace the default)
+  // go before the copy compiled into the library, there is no file access
+  // at all for that copy.
+  // The base path gets looked up here, on the calling thread, so that the
+  // worker threads never touch m_base_path. It only gets tried once.
+  if (!embedded || can_file_override) {
+    if (!m_base_path.has_value() && !m_is_base_path_missing) {
+      m_is_base_path_missing = !set_base_path();
+    }
+    if (m_base_path.has_value()) {
+      texture_path = (*m_base_path / file_path).lexically_normal();
     }
   }
-  auto texture_path = (*m_base_path / file_path).lexically_normal();
+  std::error_code error {};
+  if (embedded &&
+      (!texture_path || !std::filesystem::exists(*texture_path, error))) {
+    // No file access needed. The image still gets decoded but straight from
+    // memory:
+    return {decode_async([embedded = *embedded]() {
+      auto* surface = ::IMG_Load_RW(::SDL_RWFromConstMem(embedded.data,
+                                        static_cast<int>(embedded.size)),
+          1);
+      if (surface == nullptr) {
+        ::SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
+            "IMG_Load_RW(<embedded \"%s\">) failed: %s\n", embedded.file_path,
+            ::SDL_GetError());
+      }
+      return surface;
+    }),
+        file_path};
+  }
+  if (!texture_path) {
+    ::SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
+        "SDL_GetBasePath() failed, so \"%s\" can not be loaded\n",
+        file_path.c_str());
+    return {std::future<SDL_Surface*> {}, file_path};
+  }
 #ifdef _WIN32
-  auto texure_path_utf8 = texture_path.u8string();
+  auto texure_path_utf8 = texture_path->u8string();
 #else // On non-Windows systems the native encoding is already utf8
-  auto& texure_path_utf8 = texture_path;
+  auto texure_path_utf8 = texture_path->string();
 #endif
-  res(::IMG_LoadTexture(renderer, texure_path_utf8.c_str()));
+  return {decode_async([texure_path_utf8]() {
+    auto* surface = ::IMG_Load(texure_path_utf8.c_str());
+    if (surface == nullptr) {
+      ::SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
+          "IMG_Load(\"%s\") failed: %s\n", texure_path_utf8.c_str(),
+          ::SDL_GetError());
+    }
+    return surface;
+  }),
+      texure_path_utf8};
+}
+
+bool Texture::load(SDL_Renderer* renderer, Surface_loader&& surface_loader)
+{
+  Res_handler<SDL_Surface> surface {surface_loader.get()};
+  if (surface.res() == nullptr) {
+    return false;
+  }
+  return load(renderer, surface.res(), surface_loader.name());
+}
+
+bool Texture::load(
+    SDL_Renderer* renderer, SDL_Surface* surface, const std::string& name)
+{
+  res(::SDL_CreateTextureFromSurface(renderer, surface));
   if (res() == nullptr) {
     ::SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
-        "IMG_LoadTexture(renderer, \"%s\") failed: %s\n",
-        texure_path_utf8.c_str(), ::SDL_GetError());
+        "SDL_CreateTextureFromSurface(renderer, <\"%s\">) failed: %s\n",
+        name.c_str(), ::SDL_GetError());
     return false;
   }
   is_owned(true);
+  return refresh_texture_size(name.c_str());
+}
+
+bool Texture::refresh_texture_size(const char* texture_name)
+{
   if (::SDL_QueryTexture(res(), nullptr, nullptr, &m_texture_size.width,
           &m_texture_size.height) != 0) {
     ::SDL_LogCritical(SDL_LOG_CATEGORY_APPLICATION,
-        "Getting size of texture \"%s\" failed: %s\n",
-        texure_path_utf8.c_str(), ::SDL_GetError());
+        "Getting size of texture \"%s\" failed: %s\n", texture_name,
+        ::SDL_GetError());
     return false;
   }
   return true;
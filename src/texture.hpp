@@ -5,12 +5,45 @@
 #include <filesystem>
 #include <string>
 #include <optional>
+#include <future>
+#include <functional>
 
 #include "remotemo/config.hpp"
 #include "res_handler.hpp"
+#include "embedded_res.hpp"
 #include <SDL.h>
 
 namespace remotemo {
+// Decoding an image (into an SDL_Surface) does not need the renderer, so it
+// gets done on a worker thread while the rest of the setup goes on. Only
+// turning the surface into a texture has to wait for the renderer.
+class Surface_loader {
+public:
+  Surface_loader() noexcept = default;
+  Surface_loader(std::future<SDL_Surface*>&& surface, std::string name)
+      : m_surface(std::move(surface)), m_name(std::move(name))
+  {}
+  ~Surface_loader();
+  Surface_loader(Surface_loader&& other) noexcept = default;
+  Surface_loader& operator=(Surface_loader&& other) noexcept;
+
+  Surface_loader(const Surface_loader&) = delete;
+  Surface_loader& operator=(const Surface_loader&) = delete;
+
+  // For surfaces that are made rather than decoded from an image file.
+  static Surface_loader start(
+      std::function<SDL_Surface*()> make_surface, std::string name);
+
+  // Waits for the decoding to finish. The caller takes over the ownership of
+  // the surface (which is nullptr if the decoding failed).
+  [[nodiscard]] SDL_Surface* get();
+  [[nodiscard]] const std::string& name() const { return m_name; }
+
+private:
+  std::future<SDL_Surface*> m_surface {};
+  std::string m_name {};
+};
+
 class Texture : public Res_handler<SDL_Texture> {
 public:
   constexpr explicit Texture(
@@ -21,20 +54,33 @@ public:
       : Res_handler<SDL_Texture>(std::move(res_handler))
   {}
 
-  bool load(SDL_Renderer* renderer, const std::string& file_path);
+  static Surface_loader start_loading(const Texture_config& texture_config);
+  bool load(SDL_Renderer* renderer, Surface_loader&& surface_loader);
   [[nodiscard]] const Size& texture_size() const { return m_texture_size; }
-  static void reset_base_path() { m_base_path.reset(); }
+  static void reset_base_path()
+  {
+    m_base_path.reset();
+    m_is_base_path_missing = false;
+  }
   static bool set_base_path();
 
 protected:
   void texture_size(const Size& size) { m_texture_size = size; }
+  // Does not take over the ownership of the surface.
+  bool load(
+      SDL_Renderer* renderer, SDL_Surface* surface, const std::string& name);
 
 private:
+  bool refresh_texture_size(const char* texture_name);
+
   // This is a private static member variable. That makes it **NOT** globally
   // accessible but clang-tidy has a bug that makes it report it anyway
   // See https://github.com/llvm/llvm-project/issues/47384
   // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
   static std::optional<std::filesystem::path> m_base_path;
+  // Whether looking up the base path has failed (so it is not tried again).
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static bool m_is_base_path_missing;
   Size m_texture_size {0, 0};
 };
 } // namespace remotemo
@@ -0,0 +1,57 @@
+#include "utf8_decoder.hpp"
+
+#include <array>
+
+namespace remotemo {
+namespace {
+constexpr unsigned continuation_mask {0xc0};
+constexpr unsigned continuation_bits {0x80};
+constexpr unsigned continuation_data {0x3f};
+constexpr unsigned bits_per_continuation {6};
+constexpr char32_t max_code_point {0x10ffff};
+constexpr char32_t first_surrogate {0xd800};
+constexpr char32_t last_surrogate {0xdfff};
+
+struct Lead_byte {
+  unsigned mask;
+  unsigned bits;
+  int continuations;
+  // Anything less could have been encoded with fewer bytes:
+  char32_t min_code_point;
+};
+constexpr std::array<Lead_byte, 3> lead_bytes {{{0xe0, 0xc0, 1, 0x80},
+    {0xf0, 0xe0, 2, 0x800}, {0xf8, 0xf0, 3, 0x10000}}};
+} // namespace
+
+std::optional<char32_t> Utf8_decoder::feed(char byte)
+{
+  const auto value = static_cast<unsigned char>(byte);
+  if ((value & continuation_mask) == continuation_bits) {
+    if (m_bytes_left == 0) {
+      // Not following a lead byte.
+      return replacement_char;
+    }
+    m_code_point =
+        (m_code_point << bits_per_continuation) | (value & continuation_data);
+    if (--m_bytes_left > 0) {
+      return {};
+    }
+    if (m_code_point < m_min_code_point || m_code_point > max_code_point ||
+        (m_code_point >= first_surrogate && m_code_point <= last_surrogate)) {
+      return replacement_char;
+    }
+    return m_code_point;
+  }
+  // A lead byte, so any sequence started is cut short (and dropped):
+  for (const auto& lead : lead_bytes) {
+    if ((value & lead.mask) == lead.bits) {
+      m_code_point = value & ~lead.mask;
+      m_min_code_point = lead.min_code_point;
+      m_bytes_left = lead.continuations;
+      return {};
+    }
+  }
+  m_bytes_left = 0;
+  return replacement_char;
+}
+} // namespace remotemo
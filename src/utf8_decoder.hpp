@@ -0,0 +1,28 @@
+#ifndef REMOTEMO_SRC_UTF8_DECODER_HPP
+#define REMOTEMO_SRC_UTF8_DECODER_HPP
+
+#include <optional>
+
+namespace remotemo {
+// Turns UTF-8 into code points, fed one byte at a time (so that a character
+// can be split over more than one call to print()). Only meant for bytes
+// that are not ASCII, which are all part of a multi-byte sequence.
+class Utf8_decoder {
+public:
+  // Returns the code point once its last byte has been fed, or U+FFFD for
+  // a malformed sequence.
+  std::optional<char32_t> feed(char byte);
+  // Whether a sequence has been started but not finished.
+  [[nodiscard]] bool is_in_sequence() const { return m_bytes_left > 0; }
+  // Drops any sequence started.
+  void reset() { m_bytes_left = 0; }
+
+  static constexpr char32_t replacement_char {0xfffd};
+
+private:
+  char32_t m_code_point {0};
+  char32_t m_min_code_point {0};
+  int m_bytes_left {0};
+};
+} // namespace remotemo
+#endif // REMOTEMO_SRC_UTF8_DECODER_HPP
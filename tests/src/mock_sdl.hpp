@@ -26,7 +26,11 @@ class Mock_SDL {
   MAKE_MOCK1(mock_DestroyRenderer, void(SDL_Renderer*));
   MAKE_MOCK0(mock_GetBasePath, char*());
   MAKE_MOCK1(mock_free, void(void*));
-  MAKE_MOCK2(mock_LoadTexture, SDL_Texture*(SDL_Renderer*, const char*));
+  MAKE_MOCK1(mock_Load, SDL_Surface*(const char*));
+  MAKE_MOCK2(mock_Load_RW, SDL_Surface*(SDL_RWops*, int));
+  MAKE_MOCK1(mock_FreeSurface, void(SDL_Surface*));
+  MAKE_MOCK2(mock_CreateTextureFromSurface,
+      SDL_Texture*(SDL_Renderer*, SDL_Surface*));
   MAKE_MOCK1(mock_DestroyTexture, void(SDL_Texture*));
   MAKE_MOCK5(
       mock_CreateTexture, SDL_Texture*(SDL_Renderer*, Uint32, int, int, int));
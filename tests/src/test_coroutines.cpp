@@ -0,0 +1,145 @@
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#include "remotemo/coroutines.hpp"
+
+#include <SDL.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+// ----- Helper functions and struct ------
+namespace {
+remotemo::Config setup()
+{
+  static char env_string[] = "SDL_VIDEODRIVER=dummy";
+  putenv(&env_string[0]);
+
+  remotemo::Config config {};
+  config.clock(remotemo::Clock_mode::simulated);
+  return config;
+}
+
+void push_key(SDL_Scancode scancode, SDL_Keycode sym)
+{
+  SDL_Event ev {};
+  ev.type = SDL_KEYDOWN;
+  ev.key.state = SDL_PRESSED;
+  ev.key.keysym.mod = KMOD_NONE;
+  ev.key.keysym.scancode = scancode;
+  ev.key.keysym.sym = sym;
+  SDL_PushEvent(&ev);
+}
+
+// Sets the flag once the coroutine frame it is in gets destroyed.
+struct Destroy_flag {
+  explicit Destroy_flag(bool* is_destroyed) : is_destroyed(is_destroyed) {}
+  ~Destroy_flag() { *is_destroyed = true; }
+  Destroy_flag(Destroy_flag&&) = delete;
+  Destroy_flag& operator=(Destroy_flag&&) = delete;
+  Destroy_flag(const Destroy_flag&) = delete;
+  Destroy_flag& operator=(const Destroy_flag&) = delete;
+
+  bool* is_destroyed;
+};
+
+remotemo::co::Task<> print_and_pause(
+    remotemo::co::Monitor& mon, int line, std::string* log)
+{
+  auto result = co_await mon.print_at({0, line}, "abc");
+  REQUIRE(result == 0);
+  *log += "A1 ";
+  co_await mon.pause(50);
+  result = co_await mon.print_at({0, line + 1}, "def");
+  REQUIRE(result == 0);
+  *log += "A2 ";
+}
+
+remotemo::co::Task<> print_and_wait_for_key(
+    remotemo::co::Monitor& mon, int line, std::string* log)
+{
+  auto result = co_await mon.print_at({10, line}, "xyz");
+  REQUIRE(result == 0);
+  *log += "B1 ";
+  auto key = co_await mon.key();
+  REQUIRE(key == remotemo::Key::K_a);
+  *log += "B2 ";
+}
+
+remotemo::co::Task<> press_key_later(
+    remotemo::co::Monitor& mon, std::string* log)
+{
+  co_await mon.pause(100);
+  *log += "C ";
+  push_key(SDL_SCANCODE_A, SDLK_a);
+}
+
+remotemo::co::Task<> wait_for_key(
+    remotemo::co::Monitor& mon, bool* is_destroyed)
+{
+  const Destroy_flag flag {is_destroyed};
+  co_await mon.key();
+}
+
+remotemo::co::Task<> throw_later(remotemo::co::Monitor& mon)
+{
+  co_await mon.pause(10);
+  throw std::runtime_error {"Thrown from a task"};
+}
+} // namespace
+
+// ----- Tests ------
+
+TEST_CASE("Coroutines print, pause and wait for keys in turn",
+    "[coroutines]")
+{
+  auto t = remotemo::create(setup());
+  REQUIRE(t.has_value());
+  t->set_text_delay(10);
+  std::string log {};
+  {
+    remotemo::co::Monitor mon {*t};
+    mon.spawn(print_and_pause(mon, 0, &log));
+    mon.spawn(print_and_wait_for_key(mon, 0, &log));
+    mon.spawn(press_key_later(mon, &log));
+    REQUIRE(mon.run() == 0);
+  }
+  // Both printed 3 characters (one every 10 ms) at the same time, and the
+  // key was pressed while the first one was printing its second line:
+  REQUIRE(log == "A1 B1 C B2 A2 ");
+  REQUIRE(t->get_char_at({0, 0}) == 'a');
+  REQUIRE(t->get_char_at({2, 0}) == 'c');
+  REQUIRE(t->get_char_at({10, 0}) == 'x');
+  REQUIRE(t->get_char_at({12, 0}) == 'z');
+  REQUIRE(t->get_char_at({0, 1}) == 'd');
+  REQUIRE(t->get_char_at({2, 1}) == 'f');
+  REQUIRE(t->get_text_delay() == 10);
+}
+
+TEST_CASE("Unfinished coroutines are destroyed along with their Monitor",
+    "[coroutines]")
+{
+  auto t = remotemo::create(setup());
+  REQUIRE(t.has_value());
+  bool is_destroyed = false;
+  SECTION("Without having been run") {
+    {
+      remotemo::co::Monitor mon {*t};
+      mon.spawn(wait_for_key(mon, &is_destroyed));
+      REQUIRE_FALSE(is_destroyed);
+    }
+    REQUIRE(is_destroyed);
+  }
+  SECTION("After another one threw while running") {
+    {
+      remotemo::co::Monitor mon {*t};
+      mon.spawn(wait_for_key(mon, &is_destroyed));
+      mon.spawn(throw_later(mon));
+      REQUIRE_THROWS_AS(mon.run(), std::runtime_error);
+      REQUIRE_FALSE(is_destroyed);
+    }
+    REQUIRE(is_destroyed);
+  }
+  // Nothing is left waiting for the destroyed coroutine:
+  REQUIRE(t->run_scheduled() == 0);
+}
@@ -25,6 +25,8 @@ extern SDL_Texture* const d_new_font_bitmap;
 extern SDL_Texture* const d_conf_backgr;
 extern SDL_Texture* const d_new_backgr;
 extern SDL_Texture* const d_new_text_area;
+extern SDL_Surface* const d_new_font_surface;
+extern SDL_Surface* const d_new_backgr_surface;
 
 #ifdef _WIN32
 constexpr char d_basepath[] = "C:\\dummy\\base\\path\\";
@@ -38,6 +40,8 @@ struct Test_seqs {
   tr_seq backgr;
   tr_seq font;
   tr_seq t_area;
+  tr_seq font_decode;
+  tr_seq backgr_decode;
 };
 
 struct Resources {
@@ -105,6 +109,8 @@ struct Init_status {
   Uint32 quit_flags {0};
   std::list<tr_exp> exps {};
   Setup_cleanup_exps exps_basepath {};
+  Setup_cleanup_exps exps_backgr_surface {};
+  Setup_cleanup_exps exps_font_surface {};
   Setup_cleanup_exps exps_backgr {};
   Setup_cleanup_exps exps_font {};
   Setup_cleanup_exps exps_t_area {};
@@ -116,15 +122,21 @@ struct Init_status {
   Resources might_be_cleaned_up {};
   Resources ready_res {};
   Texture_results exp_results {};
+  SDL_Surface* backgr_surface {nullptr};
+  SDL_Surface* font_surface {nullptr};
+  // Whether a texture can only be loaded from a file (i.e. needs the base
+  // path):
+  bool is_file_needed {false};
 
   void set_res_from_config(const Conf_resources& conf);
   void attempt_init(bool should_success);
   void attempt_set_hint(bool should_success);
   void attempt_create_window(
       bool should_success, const Win_conf& win_conf = {});
-  void attempt_create_renderer(bool should_success);
-  void attempt_setup_textures(Texture_results expected_results,
+  void attempt_decode_images(Texture_results expected_results,
       const Texture_conf& texture_conf = {});
+  void attempt_create_renderer(bool should_success);
+  void attempt_setup_textures(const Texture_conf& texture_conf = {});
   void expected_cleanup();
   [[nodiscard]] bool check_a_texture_failed() const;
   void check_texture_cleanup() const;
@@ -80,9 +80,26 @@ void SDL_free(void* mem)
 {
   mock_SDL.mock_free(mem);
 }
-SDL_Texture* IMG_LoadTexture(SDL_Renderer* renderer, const char* file_path)
+SDL_Surface* IMG_Load(const char* file)
 {
-  return mock_SDL.mock_LoadTexture(renderer, file_path);
+  return mock_SDL.mock_Load(file);
+}
+SDL_Surface* IMG_Load_RW(SDL_RWops* src, int freesrc)
+{
+  auto* surface = mock_SDL.mock_Load_RW(src, freesrc);
+  if (freesrc != 0 && src != nullptr) {
+    SDL_RWclose(src);
+  }
+  return surface;
+}
+void SDL_FreeSurface(SDL_Surface* surface)
+{
+  mock_SDL.mock_FreeSurface(surface);
+}
+SDL_Texture* SDL_CreateTextureFromSurface(
+    SDL_Renderer* renderer, SDL_Surface* surface)
+{
+  return mock_SDL.mock_CreateTextureFromSurface(renderer, surface);
 }
 int SDL_QueryTexture( // Stub, not mock
     [[maybe_unused]] SDL_Texture* texture, [[maybe_unused]] Uint32* format,
@@ -131,6 +148,10 @@ Dummy_object d_5 {{"Dummy new font bitmap"}, 2};
 Dummy_object d_6 {{"Dummy conf background"}, 3};
 Dummy_object d_7 {{"Dummy new background"}, 3};
 Dummy_object d_8 {{"Dummy new text area"}, 4};
+// Except for the surfaces, which do get looked at (to see if the font bitmap
+// lacks the inversed glyphs), so those are real (if empty) ones:
+SDL_Surface d_9 {};
+SDL_Surface d_10 {};
 
 SDL_Window* const d_conf_win = reinterpret_cast<SDL_Window*>(&d_0);
 SDL_Window* const d_new_win = reinterpret_cast<SDL_Window*>(&d_1);
@@ -141,6 +162,8 @@ SDL_Texture* const d_new_font_bitmap = reinterpret_cast<SDL_Texture*>(&d_5);
 SDL_Texture* const d_conf_backgr = reinterpret_cast<SDL_Texture*>(&d_6);
 SDL_Texture* const d_new_backgr = reinterpret_cast<SDL_Texture*>(&d_7);
 SDL_Texture* const d_new_text_area = reinterpret_cast<SDL_Texture*>(&d_8);
+SDL_Surface* const d_new_font_surface = &d_9;
+SDL_Surface* const d_new_backgr_surface = &d_10;
 
 const std::array<Conf_resources, 6> valid_conf_res {
     {{nullptr, nullptr, nullptr, nullptr},
@@ -465,57 +488,146 @@ void Init_status::attempt_create_renderer(bool should_success)
   to_be_cleaned_up.render = create_render_ret;
 }
 
-void Init_status::attempt_setup_textures(
+void Init_status::attempt_decode_images(
     Texture_results expected_results, const Texture_conf& texture_conf)
 {
+  // The images get decoded on worker threads, in parallel with the creation
+  // of the window and the renderer. Hence the separate sequences.
   exp_results = expected_results;
-  if (ready_res.backgr == nullptr || ready_res.font == nullptr) {
-    exps_basepath.setup = NAMED_REQUIRE_CALL(mock_SDL, mock_GetBasePath())
-                              .TIMES(0, 1)
-                              .RETURN(exp_results.basepath)
-                              .IN_SEQUENCE(seqs.font, seqs.backgr, seqs.opt);
+  auto font_path =
+      texture_conf.font_bitmap_file_path.value_or("res/img/font_bitmap.png");
+  auto backgr_path =
+      texture_conf.backgr_file_path.value_or("res/img/terminal_screen.png");
+  // Resources compiled into the library get decoded from memory. Unless the
+  // library lets a file override them, that is without any file access
+  // (and otherwise there is no file at their path, in the dummy base path):
+  auto font_res = remotemo::Embedded_res::find(font_path);
+  auto backgr_res = remotemo::Embedded_res::find(backgr_path);
+  bool is_font_embedded = (ready_res.font == nullptr && font_res.has_value());
+  bool is_backgr_embedded =
+      (ready_res.backgr == nullptr && backgr_res.has_value());
+  bool is_font_file = (ready_res.font == nullptr && !font_res.has_value());
+  bool is_backgr_file =
+      (ready_res.backgr == nullptr && !backgr_res.has_value());
+#ifdef REMOTEMO_FILES_OVERRIDE_EMBEDDED
+  constexpr bool can_file_override {true};
+#else
+  constexpr bool can_file_override {false};
+#endif
+  // Where the base path gets looked up (once) to look for the file:
+  bool is_font_loaded =
+      is_font_file || (is_font_embedded && can_file_override);
+  bool is_backgr_loaded =
+      is_backgr_file || (is_backgr_embedded && can_file_override);
+  is_file_needed = is_font_file || is_backgr_file;
+  if (is_font_loaded || is_backgr_loaded) {
+    if (is_font_loaded && is_backgr_loaded) {
+      exps_basepath.setup =
+          NAMED_REQUIRE_CALL(mock_SDL, mock_GetBasePath())
+              .TIMES(0, 1)
+              .RETURN(exp_results.basepath)
+              .IN_SEQUENCE(seqs.font_decode, seqs.backgr_decode, seqs.opt);
+    } else if (is_font_loaded) {
+      exps_basepath.setup = NAMED_REQUIRE_CALL(mock_SDL, mock_GetBasePath())
+                                .TIMES(0, 1)
+                                .RETURN(exp_results.basepath)
+                                .IN_SEQUENCE(seqs.font_decode, seqs.opt);
+    } else {
+      exps_basepath.setup = NAMED_REQUIRE_CALL(mock_SDL, mock_GetBasePath())
+                                .TIMES(0, 1)
+                                .RETURN(exp_results.basepath)
+                                .IN_SEQUENCE(seqs.backgr_decode, seqs.opt);
+    }
     exps_basepath.cleanup = NAMED_REQUIRE_CALL(
         mock_SDL, mock_free(static_cast<void*>(exp_results.basepath)))
                                 .TIMES(0, 1)
                                 .IN_SEQUENCE(seqs.opt);
   }
-  if (exp_results.basepath != nullptr) {
+  std::regex backslash_re("\\\\");
+  if (is_font_embedded || (is_font_file && exp_results.basepath != nullptr)) {
+    font_surface = exp_results.font != nullptr ? d_new_font_surface : nullptr;
+  }
+  if (is_font_embedded) {
+    // Tell the embedded resources apart by their size:
+    auto res_size = static_cast<Sint64>(font_res->size);
+    exps_font_surface.setup = NAMED_REQUIRE_CALL(mock_SDL, mock_Load_RW(_, 1))
+                                  .WITH(SDL_RWsize(_1) == res_size)
+                                  .TIMES(0, 1)
+                                  .RETURN(font_surface)
+                                  .IN_SEQUENCE(seqs.font_decode);
+  } else if (is_font_file && exp_results.basepath != nullptr) {
+    std::filesystem::path base_path {exp_results.basepath};
+    auto font_full_path = (base_path / font_path).lexically_normal();
+    std::string regex_path =
+        "^"s +
+        std::regex_replace(font_full_path.string(), backslash_re, "\\\\") +
+        "$";
+    exps_font_surface.setup =
+        NAMED_REQUIRE_CALL(mock_SDL, mock_Load(re(regex_path)))
+            .TIMES(0, 1)
+            .RETURN(font_surface)
+            .IN_SEQUENCE(seqs.font_decode);
+  }
+  if (font_surface != nullptr) {
+    // Freed either once the texture has been created or, if the setup fails
+    // before that, when create() returns.
+    exps_font_surface.cleanup =
+        NAMED_REQUIRE_CALL(mock_SDL, mock_FreeSurface(font_surface))
+            .TIMES(0, 1);
+  }
+  if (is_backgr_embedded ||
+      (is_backgr_file && exp_results.basepath != nullptr)) {
+    backgr_surface =
+        exp_results.backgr != nullptr ? d_new_backgr_surface : nullptr;
+  }
+  if (is_backgr_embedded) {
+    auto res_size = static_cast<Sint64>(backgr_res->size);
+    exps_backgr_surface.setup =
+        NAMED_REQUIRE_CALL(mock_SDL, mock_Load_RW(_, 1))
+            .WITH(SDL_RWsize(_1) == res_size)
+            .TIMES(0, 1)
+            .RETURN(backgr_surface)
+            .IN_SEQUENCE(seqs.backgr_decode);
+  } else if (is_backgr_file && exp_results.basepath != nullptr) {
     std::filesystem::path base_path {exp_results.basepath};
-    std::regex backslash_re("\\\\");
-    if (ready_res.font == nullptr) {
-      auto font_full_path =
-          (base_path / texture_conf.font_bitmap_file_path.value_or(
-                           "res/img/font_bitmap.png"))
-              .lexically_normal();
-      std::string regex_path =
-          "^"s +
-          std::regex_replace(font_full_path.string(), backslash_re, "\\\\") +
-          "$";
-      exps_font.setup = NAMED_REQUIRE_CALL(
-          mock_SDL, mock_LoadTexture(ready_res.render, re(regex_path)))
+    auto backgr_full_path = (base_path / backgr_path).lexically_normal();
+    std::string regex_path =
+        "^"s +
+        std::regex_replace(
+            backgr_full_path.string(), backslash_re, "\\\\") +
+        "$";
+    exps_backgr_surface.setup =
+        NAMED_REQUIRE_CALL(mock_SDL, mock_Load(re(regex_path)))
+            .TIMES(0, 1)
+            .RETURN(backgr_surface)
+            .IN_SEQUENCE(seqs.backgr_decode);
+  }
+  if (backgr_surface != nullptr) {
+    exps_backgr_surface.cleanup =
+        NAMED_REQUIRE_CALL(mock_SDL, mock_FreeSurface(backgr_surface))
+            .TIMES(0, 1);
+  }
+}
+
+void Init_status::attempt_setup_textures(const Texture_conf& texture_conf)
+{
+  if (font_surface != nullptr) {
+    exps_font.setup = NAMED_REQUIRE_CALL(mock_SDL,
+        mock_CreateTextureFromSurface(ready_res.render, font_surface))
+                          .TIMES(0, 1)
+                          .RETURN(exp_results.font)
+                          .IN_SEQUENCE(seqs.font, seqs.font_decode);
+    ready_res.font = exp_results.font;
+    might_be_cleaned_up.font = exp_results.font;
+  }
+  if (backgr_surface != nullptr) {
+    exps_backgr.setup = NAMED_REQUIRE_CALL(mock_SDL,
+        mock_CreateTextureFromSurface(ready_res.render, backgr_surface))
                             .TIMES(0, 1)
-                            .RETURN(exp_results.font)
-                            .IN_SEQUENCE(seqs.font);
-      ready_res.font = exp_results.font;
-      might_be_cleaned_up.font = exp_results.font;
-    }
-    if (ready_res.backgr == nullptr) {
-      auto backgr_full_path =
-          (base_path / texture_conf.backgr_file_path.value_or(
-                           "res/img/terminal_screen.png"))
-              .lexically_normal();
-      std::string regex_path = "^"s +
-                               std::regex_replace(backgr_full_path.string(),
-                                   backslash_re, "\\\\") +
-                               "$";
-      exps_backgr.setup = NAMED_REQUIRE_CALL(
-          mock_SDL, mock_LoadTexture(ready_res.render, re(regex_path)))
-                              .TIMES(0, 1)
-                              .RETURN(exp_results.backgr)
-                              .IN_SEQUENCE(seqs.backgr);
-      ready_res.backgr = exp_results.backgr;
-      might_be_cleaned_up.backgr = exp_results.backgr;
-    }
+                            .RETURN(exp_results.backgr)
+                            .IN_SEQUENCE(seqs.backgr, seqs.backgr_decode);
+    ready_res.backgr = exp_results.backgr;
+    might_be_cleaned_up.backgr = exp_results.backgr;
   }
   // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
   auto font_size = texture_conf.font_size.value_or(remotemo::Size {7, 18});
@@ -585,16 +697,16 @@ void Init_status::expected_cleanup()
 
 bool Init_status::check_a_texture_failed() const
 {
-  if (exp_results.basepath == nullptr && exps_basepath.setup &&
-      exps_basepath.setup->is_saturated()) {
+  if (exp_results.basepath == nullptr && is_file_needed &&
+      exps_basepath.setup && exps_basepath.setup->is_saturated()) {
     return true;
   }
-  if (might_be_cleaned_up.font == nullptr && exps_font.setup &&
-      exps_font.setup->is_saturated()) {
+  if (font_surface == nullptr && exps_font_surface.setup &&
+      exps_font_surface.setup->is_saturated()) {
     return true;
   }
-  if (might_be_cleaned_up.backgr == nullptr && exps_backgr.setup &&
-      exps_backgr.setup->is_saturated()) {
+  if (backgr_surface == nullptr && exps_backgr_surface.setup &&
+      exps_backgr_surface.setup->is_saturated()) {
     return true;
   }
   if (might_be_cleaned_up.t_area == nullptr && exps_t_area.setup &&
@@ -610,6 +722,14 @@ void Init_status::check_texture_cleanup() const
     REQUIRE(exps_basepath.setup->is_saturated() ==
             exps_basepath.cleanup->is_saturated());
   }
+  if (font_surface != nullptr) {
+    REQUIRE(exps_font_surface.setup->is_saturated() ==
+            exps_font_surface.cleanup->is_saturated());
+  }
+  if (backgr_surface != nullptr) {
+    REQUIRE(exps_backgr_surface.setup->is_saturated() ==
+            exps_backgr_surface.cleanup->is_saturated());
+  }
   if (might_be_cleaned_up.font != nullptr) {
     REQUIRE(
         exps_font.setup->is_saturated() == exps_font.cleanup->is_saturated());
@@ -47,6 +47,9 @@ TEST_CASE("create() - resourceless config - create window fails:", "[init]")
   auto do_cleanup_all = GENERATE(false, true);
   auto conf = valid_conf_res[0];
   auto set_hint = GENERATE(false, true);
+  char* d_bpath = const_cast<char*>(&d_basepath[0]);
+  Texture_results textures {
+      d_bpath, d_new_font_bitmap, d_new_backgr, d_new_text_area};
   DYNAMIC_SECTION(
       "... SDL_Init() succeeds, ...\n"
       << "... SDL_SetHint() "
@@ -62,6 +65,7 @@ TEST_CASE("create() - resourceless config - create window fails:", "[init]")
 
     init.attempt_init(true);
     init.attempt_set_hint(set_hint);
+    init.attempt_decode_images(textures);
     init.attempt_create_window(false);
 
     if (do_cleanup_all) {
@@ -93,6 +97,9 @@ TEST_CASE(
   init.do_cleanup_all = do_cleanup_all;
   auto conf = GENERATE_REF(valid_conf_res[0], valid_conf_res[1]);
   auto set_hint = GENERATE(false, true);
+  char* d_bpath = const_cast<char*>(&d_basepath[0]);
+  Texture_results textures {
+      d_bpath, d_new_font_bitmap, d_new_backgr, d_new_text_area};
   DYNAMIC_SECTION(
       "... SDL_Init() succeeds, ...\n"
       << "... SDL_SetHint() "
@@ -110,6 +117,7 @@ TEST_CASE(
 
     init.attempt_init(true);
     init.attempt_set_hint(set_hint);
+    init.attempt_decode_images(textures);
     if (init.ready_res.win == nullptr) {
       init.attempt_create_window(true);
     }
@@ -186,6 +194,7 @@ TEST_CASE("create() - valid config - setup of textures fails:", "[init]")
 
     init.attempt_init(true);
     init.attempt_set_hint(set_hint);
+    init.attempt_decode_images(textures);
     if (init.ready_res.win == nullptr) {
       init.attempt_create_window(true);
     }
@@ -193,7 +202,7 @@ TEST_CASE("create() - valid config - setup of textures fails:", "[init]")
       init.attempt_create_renderer(true);
     }
 
-    init.attempt_setup_textures(textures);
+    init.attempt_setup_textures();
 
     init.expected_cleanup();
     require_init_has_ended(&exps, &seqs);
@@ -242,6 +251,7 @@ TEST_CASE("create() - all succeeds:", "[init]")
 
     init.attempt_init(true);
     init.attempt_set_hint(set_hint);
+    init.attempt_decode_images(textures);
     if (init.ready_res.win == nullptr) {
       init.attempt_create_window(true);
     }
@@ -249,7 +259,7 @@ TEST_CASE("create() - all succeeds:", "[init]")
       init.attempt_create_renderer(true);
     }
 
-    init.attempt_setup_textures(textures);
+    init.attempt_setup_textures();
 
     require_init_has_ended(&exps, &seqs);
     init.expected_cleanup();
@@ -309,9 +319,10 @@ TEST_CASE("create() succeeds - test if config is used to create the window:",
 
     init.attempt_init(true);
     init.attempt_set_hint(set_hint);
+    init.attempt_decode_images(textures);
     init.attempt_create_window(true, win_conf);
     init.attempt_create_renderer(true);
-    init.attempt_setup_textures(textures);
+    init.attempt_setup_textures();
 
     require_init_has_ended(&exps, &seqs);
     init.expected_cleanup();
@@ -370,9 +381,10 @@ TEST_CASE("create() succeeds - test if config is used to setup the textures:",
 
     init.attempt_init(true);
     init.attempt_set_hint(set_hint);
+    init.attempt_decode_images(textures, texture_conf);
     init.attempt_create_window(true);
     init.attempt_create_renderer(true);
-    init.attempt_setup_textures(textures, texture_conf);
+    init.attempt_setup_textures(texture_conf);
 
     require_init_has_ended(&exps, &seqs);
     init.expected_cleanup();
@@ -407,9 +419,10 @@ TEST_CASE("create() succeeds - test if move ctor and move assignment works:",
   init.set_res_from_config(conf_res);
   init.attempt_init(true);
   init.attempt_set_hint(set_hint);
+  init.attempt_decode_images(textures);
   init.attempt_create_window(true);
   init.attempt_create_renderer(true);
-  init.attempt_setup_textures(textures);
+  init.attempt_setup_textures();
   require_init_has_ended(&exps, &seqs);
   init.expected_cleanup();
 
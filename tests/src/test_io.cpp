@@ -6,11 +6,17 @@
 #include <string>
 #include <cmath>
 #include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <cstdint>
+#include <utility>
 
 #include "remotemo/remotemo.hpp"
 #include "../../src/engine.hpp"
 
 #include <SDL.h>
+#include <SDL_image.h>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators_range.hpp>
@@ -114,6 +120,20 @@ remotemo::Config setup(int columns = 0, int lines = 0)
   return config;
 }
 
+// Saves a blank font bitmap, with characters the size of the default font,
+// and the given number of pages (e.g. 2 for ASCII and Latin-1):
+void save_blank_font(const std::string& path, int pages)
+{
+  constexpr int char_width = 7;
+  constexpr int char_height = 18;
+  constexpr int page_height = 16 * char_height;
+  auto* surface = SDL_CreateRGBSurfaceWithFormat(
+      0, 16 * char_width, pages * page_height, 32, SDL_PIXELFORMAT_RGBA32);
+  REQUIRE(surface != nullptr);
+  REQUIRE(IMG_SavePNG(surface, path.c_str()) == 0);
+  SDL_FreeSurface(surface);
+}
+
 struct Get_key_test_param {
   SDL_Scancode scancode; // pressed key physical code.
   SDL_Keycode sym;       // pressed key virtual code.
@@ -413,6 +433,9 @@ TEST_CASE("pause(int)", "[pause]")
 {
   constexpr int allowed_error = 20;
   auto config = setup();
+  // The time paused gets checked by the monitor's own (simulated) clock, so
+  // that the test does not have to wait:
+  config.clock(remotemo::Clock_mode::simulated);
   auto t = remotemo::create(config);
   t->set_text_delay(0);
 
@@ -423,20 +446,79 @@ TEST_CASE("pause(int)", "[pause]")
     }
   }
 
-  SECTION("pause(int), with positive parameters, should wait for aproximate "
-          "the given time (in milliseconds)")
+  SECTION("pause(int), with positive parameters, should wait for the given "
+          "time (in milliseconds)")
   {
     for (int ok_duration : {0, 1, 35, 490, 2000, 10'000}) {
-      auto start = std::chrono::high_resolution_clock::now();
+      t->reset_stats();
       REQUIRE(t->pause(ok_duration) == 0);
-      auto end = std::chrono::high_resolution_clock::now();
-      auto elapsed_ms =
-          std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-      UNSCOPED_INFO("pause(" << ok_duration << ") took " << elapsed_ms.count()
-                             << "ms to run.\n");
-      REQUIRE(abs(elapsed_ms.count() - ok_duration) < allowed_error);
+      REQUIRE(t->stats().delay_ms == ok_duration);
     }
   }
+
+  SECTION("pause(int), with the real clock, should wait for aproximate the "
+          "given time (in milliseconds)")
+  {
+    constexpr int ok_duration = 35;
+    t.reset();
+    auto real_t = remotemo::create(setup());
+    real_t->set_text_delay(0);
+    auto start = std::chrono::high_resolution_clock::now();
+    REQUIRE(real_t->pause(ok_duration) == 0);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto elapsed_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    UNSCOPED_INFO("pause(" << ok_duration << ") took " << elapsed_ms.count()
+                           << "ms to run.\n");
+    REQUIRE(abs(elapsed_ms.count() - ok_duration) < allowed_error);
+  }
+}
+
+TEST_CASE("With a simulated clock, delays take no real time",
+    "[pause][clock]")
+{
+  constexpr int pause_ms = 10'000;
+  constexpr int delay_ms = 200;
+  constexpr int max_real_ms = 1'000;
+  auto config = setup();
+  config.clock(remotemo::Clock_mode::simulated);
+  auto t = remotemo::create(config);
+  REQUIRE(t->set_text_delay(delay_ms));
+  const std::string text {"Foo!"};
+
+  auto start = std::chrono::steady_clock::now();
+  REQUIRE(t->pause(pause_ms) == 0);
+  REQUIRE(t->print(text) == 0);
+  auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  REQUIRE(elapsed_ms.count() < max_real_ms);
+  // As far as the monitor is concerned, the time did pass:
+  REQUIRE(t->stats().delay_ms ==
+          pause_ms + delay_ms * static_cast<int>(text.size()));
+  REQUIRE(t->get_char_at({3, 0}) == '!');
+}
+
+TEST_CASE("Without delays, a simulated clock renders the same frames",
+    "[clock][stats]")
+{
+  // Returns the stats of doing the same with the given clock:
+  auto run = [](remotemo::Clock_mode clock) {
+    auto config = setup();
+    config.clock(clock);
+    auto t = remotemo::create(config);
+    REQUIRE(t.has_value());
+    t->set_text_delay(0);
+    t->reset_stats();
+    REQUIRE(t->print("Foo\nbar") == 0);
+    REQUIRE(t->set_cursor(1, 1) == 0);
+    t->clear();
+    return t->stats();
+  };
+  const auto real = run(remotemo::Clock_mode::real);
+  const auto simulated = run(remotemo::Clock_mode::simulated);
+  REQUIRE(simulated.delay_ms == 0.0);
+  REQUIRE(simulated.frames_presented == real.frames_presented);
+  REQUIRE(simulated.render_copy_calls == real.render_copy_calls);
 }
 
 TEST_CASE("print() and print_at() functions", "[print]")
@@ -446,7 +528,15 @@ TEST_CASE("print() and print_at() functions", "[print]")
   const std::string empty_line(columns, ' ');
   const std::deque<bool> normal_line(columns, false);
   auto config = setup(columns, lines);
+  // With the Latin-1 page, for printing non-ASCII characters:
+  const auto font_path =
+      (std::filesystem::temp_directory_path() / "remotemo_test_print.png")
+          .string();
+  save_blank_font(font_path, 2);
+  config.font_bitmap_file_path(font_path);
   auto eng = remotemo::Engine::create(config);
+  std::filesystem::remove(font_path);
+  REQUIRE(eng);
   auto* engine = eng.get();
   remotemo::Remotemo t = remotemo::create_remotemo(std::move(eng), config);
   t.set_text_delay(0);
@@ -508,43 +598,48 @@ TEST_CASE("print() and print_at() functions", "[print]")
 
   SECTION("Printing non-ascii characters")
   {
-    for (auto text : {"Fóö!"s, "_bär_"s, "<ßpåm>"s}) {
-      REQUIRE(t.print(text + '\n') == 0);
-      for (auto& c : text) {
-        if (c < 0 || c > 127) {
-          c = 1;
-        }
+    // One square per character, each shown with its glyph of the Latin-1
+    // page (get_char_at() gives 1 for any character that is not ASCII):
+    const std::vector<std::pair<std::string, std::u32string>> texts {
+        {"Fóö!", U"Fóö!"}, {"_bär_", U"_bär_"}, {"<ßpåm>", U"<ßpåm>"}};
+    for (const auto& [text, code_points] : texts) {
+      REQUIRE(t.print(text) == 0);
+      std::string shown {};
+      for (int i = 0; i < static_cast<int>(code_points.size()); i++) {
+        const auto code_point = code_points[i];
+        shown += code_point > 127 ? '\1' : static_cast<char>(code_point);
+        REQUIRE(engine->code_point_at({i, expected_cursor_pos.y}) ==
+                code_point);
       }
       expected_content.text[expected_cursor_pos.y].replace(
-          expected_cursor_pos.x, text.size(), text);
+          0, shown.size(), shown);
+      expected_cursor_pos.x = static_cast<int>(code_points.size());
+      check_status(expected_content, expected_cursor_pos, engine);
+      REQUIRE(t.print("\n") == 0);
       expected_cursor_pos.x = 0;
       expected_cursor_pos.y++;
-      check_status(expected_content, expected_cursor_pos, engine);
     }
   }
 }
 
 TEST_CASE("print() with delay", "[print][pause]")
 {
-  constexpr int allowed_error = 50;
-  auto t = remotemo::create(setup());
+  auto config = setup();
+  // The delays get checked by the monitor's own (simulated) clock, so that
+  // the test does not have to wait:
+  config.clock(remotemo::Clock_mode::simulated);
+  auto t = remotemo::create(config);
 
   for (int delay_ms : {0, 30, 60, 100, 200}) {
     t->set_cursor(0, 0);
     t->set_text_delay(delay_ms);
     for (const auto& text : {"Foo!"s, "_bar_"s, "<spam>"s}) {
       int expected_duration = delay_ms * static_cast<int>(text.size());
-      auto start = std::chrono::high_resolution_clock::now();
-      t->print(text);
-      auto end = std::chrono::high_resolution_clock::now();
-      auto elapsed_ms =
-          std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+      t->reset_stats();
+      REQUIRE(t->print(text) == 0);
       UNSCOPED_INFO("print(\"" << text << "\") with delay per char "
-                               << delay_ms << "ms and expected time "
-                               << expected_duration << "ms took "
-                               << elapsed_ms.count() << "ms to run.\n");
-      REQUIRE(abs(elapsed_ms.count() - expected_duration) / text.size() <
-              allowed_error);
+                               << delay_ms << "ms");
+      REQUIRE(t->stats().delay_ms == expected_duration);
     }
   }
 }
@@ -556,7 +651,15 @@ TEST_CASE("print() - scroll set to true", "[print][scroll]")
   const std::string empty_line(columns, ' ');
   const std::deque<bool> normal_line(columns, false);
   auto config = setup(columns, lines);
+  // With the Latin-1 page, for printing non-ASCII characters:
+  const auto font_path =
+      (std::filesystem::temp_directory_path() / "remotemo_test_print.png")
+          .string();
+  save_blank_font(font_path, 2);
+  config.font_bitmap_file_path(font_path);
   auto eng = remotemo::Engine::create(config);
+  std::filesystem::remove(font_path);
+  REQUIRE(eng);
   auto* engine = eng.get();
   remotemo::Remotemo t = remotemo::create_remotemo(std::move(eng), config);
   t.set_text_delay(0);
@@ -625,7 +728,15 @@ TEST_CASE("print() - wrap set to character", "[print][wrap]")
   const std::string empty_line(columns, ' ');
   const std::deque<bool> normal_line(columns, false);
   auto config = setup(columns, lines);
+  // With the Latin-1 page, for printing non-ASCII characters:
+  const auto font_path =
+      (std::filesystem::temp_directory_path() / "remotemo_test_print.png")
+          .string();
+  save_blank_font(font_path, 2);
+  config.font_bitmap_file_path(font_path);
   auto eng = remotemo::Engine::create(config);
+  std::filesystem::remove(font_path);
+  REQUIRE(eng);
   auto* engine = eng.get();
   remotemo::Remotemo t = remotemo::create_remotemo(std::move(eng), config);
   t.set_text_delay(0);
@@ -689,7 +800,15 @@ TEST_CASE("print() - scroll is on and wrap set to character",
   const std::string empty_line(columns, ' ');
   const std::deque<bool> normal_line(columns, false);
   auto config = setup(columns, lines);
+  // With the Latin-1 page, for printing non-ASCII characters:
+  const auto font_path =
+      (std::filesystem::temp_directory_path() / "remotemo_test_print.png")
+          .string();
+  save_blank_font(font_path, 2);
+  config.font_bitmap_file_path(font_path);
   auto eng = remotemo::Engine::create(config);
+  std::filesystem::remove(font_path);
+  REQUIRE(eng);
   auto* engine = eng.get();
   remotemo::Remotemo t = remotemo::create_remotemo(std::move(eng), config);
   t.set_text_delay(0);
@@ -747,6 +866,1152 @@ TEST_CASE("set_inverse() should affect the 'inverse' setting", "[inverse]")
   }
 }
 
+TEST_CASE("Startup timings are only measured if asked for", "[timings]")
+{
+  SECTION("Not measured by default")
+  {
+    auto t = remotemo::create(setup());
+    REQUIRE(t->startup_timings().has_value() == false);
+  }
+
+  SECTION("Measured when asked for")
+  {
+    auto config = setup();
+    config.startup_timing(remotemo::Startup_timing_mode::measure);
+    auto t = remotemo::create(config);
+    auto timings = t->startup_timings();
+    REQUIRE(timings.has_value());
+    double phases_ms {0.0};
+    for (double phase_ms : {timings->preparation_ms, timings->sdl_init_ms,
+             timings->window_ms, timings->renderer_ms, timings->font_ms,
+             timings->background_ms, timings->text_area_ms}) {
+      REQUIRE(phase_ms >= 0.0);
+      phases_ms += phase_ms;
+    }
+    REQUIRE(phases_ms <= timings->create_ms);
+    REQUIRE(timings->first_render_ms.has_value() == false);
+
+    t->set_text_delay(0);
+    REQUIRE(t->print("Foo") == 0);
+    timings = t->startup_timings();
+    REQUIRE(timings->first_render_ms.has_value());
+    REQUIRE(timings->until_first_render_ms.has_value());
+    REQUIRE(*timings->until_first_render_ms >= *timings->first_render_ms);
+    REQUIRE(*timings->until_first_render_ms >= timings->create_ms);
+  }
+}
+
+TEST_CASE("Render statistics are collected and can be reset", "[stats]")
+{
+  constexpr int pause_ms = 50;
+  constexpr int allowed_error = 20;
+  auto t = remotemo::create(setup());
+  t->set_text_delay(0);
+
+  REQUIRE(t->print("Foo\nbar") == 0);
+  REQUIRE(t->pause(pause_ms) == 0);
+  auto stats = t->stats();
+  REQUIRE(stats.delay_ms >= pause_ms - allowed_error);
+  REQUIRE(stats.frames_presented ==
+          stats.full_refreshes + stats.partial_refreshes);
+  Uint64 histogram_total = 0;
+  for (auto frames : stats.frame_time_histogram) {
+    histogram_total += frames;
+  }
+  // The first frame has no previous one to be timed against:
+  REQUIRE(histogram_total + (stats.frames_presented > 0 ? 1 : 0) ==
+          stats.frames_presented);
+
+  t->reset_stats();
+  stats = t->stats();
+  REQUIRE(stats.frames_presented == 0);
+  REQUIRE(stats.render_copy_calls == 0);
+  REQUIRE(stats.render_target_switches == 0);
+  REQUIRE(stats.full_refreshes == 0);
+  REQUIRE(stats.partial_refreshes == 0);
+  REQUIRE(stats.delay_ms == 0.0);
+  REQUIRE(stats.render_ms == 0.0);
+}
+
+TEST_CASE("Output can be queued from other threads through a handle",
+    "[handle]")
+{
+  constexpr int columns = 20;
+  constexpr int lines = 4;
+  constexpr int pause_ms = 50;
+  const std::string empty_line(columns, ' ');
+  const std::deque<bool> normal_line(columns, false);
+  auto config = setup(columns, lines);
+  // With the Latin-1 page, for printing non-ASCII characters:
+  const auto font_path =
+      (std::filesystem::temp_directory_path() / "remotemo_test_print.png")
+          .string();
+  save_blank_font(font_path, 2);
+  config.font_bitmap_file_path(font_path);
+  auto eng = remotemo::Engine::create(config);
+  std::filesystem::remove(font_path);
+  REQUIRE(eng);
+  auto* engine = eng.get();
+  remotemo::Remotemo t = remotemo::create_remotemo(std::move(eng), config);
+  t.set_text_delay(0);
+  Console_content expected_content {lines, empty_line, normal_line};
+
+  auto handle = t.handle();
+  std::thread producer {[handle]() {
+    handle.set_cursor(2, 1);
+    handle.set_inverse(true);
+    handle.print("Foo");
+    handle.set_inverse(false);
+    handle.set_cursor(columns, 0); // Invalid, so should be ignored
+    handle.print("bar");
+  }};
+  producer.join();
+  // Nothing gets done until the owning thread updates the window:
+  check_status(expected_content, {0, 0}, engine);
+
+  REQUIRE(t.pause(pause_ms) == 0);
+  expected_content.text[1].replace(2, 6, "Foobar");
+  for (int column = 2; column < 5; column++) {
+    expected_content.is_inv[1][column] = true;
+  }
+  check_status(expected_content, {8, 1}, engine);
+
+  SECTION("Clearing the screen can also be queued")
+  {
+    handle.clear();
+    REQUIRE(t.pause(pause_ms) == 0);
+    check_status({lines, empty_line, normal_line}, {0, 0}, engine);
+  }
+  SECTION("Requests to a monitor that no longer exists are dropped")
+  {
+    {
+      remotemo::Remotemo gone = std::move(t);
+    }
+    handle.print("Lost");
+  }
+}
+
+TEST_CASE("A recorded session can be replayed", "[record][replay]")
+{
+  constexpr int columns = 20;
+  constexpr int lines = 4;
+  const std::string empty_line(columns, ' ');
+  const std::deque<bool> normal_line(columns, false);
+  const auto trace_file =
+      (std::filesystem::temp_directory_path() / "remotemo_test_trace.bin")
+          .string();
+  {
+    auto config = setup(columns, lines);
+    config.record_session_file(trace_file);
+    auto t = remotemo::create(config);
+    REQUIRE(t.has_value());
+    t->set_text_delay(0);
+    t->print("Cleared");
+    t->clear();
+    t->set_cursor(3, 2);
+    t->set_inverse(true);
+    t->print("Foo");
+    t->set_inverse(false);
+    t->move_cursor(-3, -1);
+    t->print("bar");
+    // Settings that change how later prints get laid out:
+    t->set_scrolling(false);
+    t->set_wrapping(remotemo::Wrapping::off);
+  }
+  auto config = setup(columns, lines);
+  auto eng = remotemo::Engine::create(config);
+  auto* engine = eng.get();
+  remotemo::Remotemo t = remotemo::create_remotemo(std::move(eng), config);
+  t.set_text_delay(1);
+
+  REQUIRE(t.replay(
+              trace_file, remotemo::Replay_speed::as_fast_as_possible) == 0);
+  Console_content expected_content {lines, empty_line, normal_line};
+  expected_content.text[2].replace(3, 3, "Foo");
+  expected_content.text[1].replace(3, 3, "bar");
+  for (int column = 3; column < 6; column++) {
+    expected_content.is_inv[2][column] = true;
+  }
+  check_status(expected_content, {6, 1}, engine);
+  REQUIRE(t.get_scrolling() == false);
+  REQUIRE(t.get_wrapping() == remotemo::Wrapping::off);
+  // The delay between characters is restored afterwards:
+  REQUIRE(t.get_text_delay() == 1);
+  // Also when replaying the delay that got recorded:
+  REQUIRE(t.replay(trace_file, remotemo::Replay_speed::original) == 0);
+  REQUIRE(t.get_text_delay() == 1);
+
+  REQUIRE(t.replay(trace_file + ".does_not_exist") == -1);
+
+  std::filesystem::remove(trace_file);
+}
+
+TEST_CASE("What gets replayed is not recorded again", "[record][replay]")
+{
+  constexpr int columns = 20;
+  constexpr int lines = 4;
+  const std::string empty_line(columns, ' ');
+  const std::deque<bool> normal_line(columns, false);
+  const auto trace_dir = std::filesystem::temp_directory_path();
+  const auto first_trace_file =
+      (trace_dir / "remotemo_test_first.bin").string();
+  const auto second_trace_file =
+      (trace_dir / "remotemo_test_second.bin").string();
+  auto config = setup(columns, lines);
+  {
+    config.record_session_file(first_trace_file);
+    auto t = remotemo::create(config);
+    REQUIRE(t.has_value());
+    t->set_text_delay(0);
+    t->set_cursor(3, 2);
+    t->print("Foo");
+  }
+  {
+    // Records the replay (of the first session) and then some more:
+    config.record_session_file(second_trace_file);
+    auto t = remotemo::create(config);
+    REQUIRE(t.has_value());
+    REQUIRE(t->replay(first_trace_file,
+                remotemo::Replay_speed::as_fast_as_possible) == 0);
+    t->set_text_delay(0);
+    t->print("X");
+  }
+  config.record_session_file("");
+  auto eng = remotemo::Engine::create(config);
+  auto* engine = eng.get();
+  remotemo::Remotemo t = remotemo::create_remotemo(std::move(eng), config);
+  REQUIRE(t.replay(second_trace_file,
+              remotemo::Replay_speed::as_fast_as_possible) == 0);
+  // Only what was done after the replay:
+  Console_content expected_content {lines, empty_line, normal_line};
+  expected_content.text[0].replace(0, 1, "X");
+  check_status(expected_content, {1, 0}, engine);
+  std::filesystem::remove(first_trace_file);
+  std::filesystem::remove(second_trace_file);
+}
+
+TEST_CASE("Presented frames can be captured to files", "[capture]")
+{
+  const auto capture_dir =
+      std::filesystem::temp_directory_path() / "remotemo_test_capture";
+  std::filesystem::remove_all(capture_dir);
+  std::filesystem::create_directories(capture_dir);
+  const auto path_prefix = (capture_dir / "frame_").string();
+  remotemo::Render_stats stats {};
+  {
+    auto config = setup();
+    config.capture_frames(path_prefix, remotemo::Capture_format::ppm);
+    auto t = remotemo::create(config);
+    REQUIRE(t.has_value());
+    t->set_text_delay(0);
+    REQUIRE(t->print("Foo") == 0);
+    stats = t->stats();
+  }
+  // All the captured frames have been written once the monitor is gone:
+  REQUIRE(stats.frames_captured > 0);
+  REQUIRE(stats.frames_captured + stats.frames_capture_dropped ==
+          stats.frames_presented);
+  std::ifstream first_frame {path_prefix + "000000.ppm", std::ios::binary};
+  REQUIRE(first_frame.is_open());
+  std::string magic {};
+  first_frame >> magic;
+  REQUIRE(magic == "P6");
+  auto frame_count = std::distance(
+      std::filesystem::directory_iterator {capture_dir},
+      std::filesystem::directory_iterator {});
+  REQUIRE(static_cast<Uint64>(frame_count) == stats.frames_captured);
+  first_frame.close();
+  std::filesystem::remove_all(capture_dir);
+}
+
+TEST_CASE("Lines scrolled off the top are kept in a bounded scrollback",
+    "[scrollback][scroll]")
+{
+  constexpr int columns = 10;
+  constexpr int lines = 3;
+  constexpr int scrollback_lines = 4;
+  auto config = setup(columns, lines);
+  config.scrollback_lines(scrollback_lines);
+  auto t = remotemo::create(config);
+  t->set_text_delay(0);
+  REQUIRE(t->get_scrollback_size() == 0);
+
+  // Scrolls once, when printing the "4":
+  t->print("1\n2\n3\n4");
+  REQUIRE(t->get_scrollback_size() == 1);
+  t->print("\n5\n6\n7\n8\n");
+  // Never more than the capacity:
+  REQUIRE(t->get_scrollback_size() == scrollback_lines);
+
+  REQUIRE(t->set_scrollback_view(2) == 0);
+  REQUIRE(t->get_scrollback_view() == 2);
+  REQUIRE(t->set_scrollback_view(scrollback_lines + 1) == -1);
+  REQUIRE(t->get_scrollback_view() == scrollback_lines);
+  REQUIRE(t->set_scrollback_view(-1) == -1);
+  REQUIRE(t->get_scrollback_view() == 0);
+
+  // Scrolling the view does not change the content of the text area:
+  REQUIRE(t->set_scrollback_view(1) == 0);
+  REQUIRE(t->get_char_at({0, 0}) == '6');
+  // Printing brings the view back:
+  t->print("9");
+  REQUIRE(t->get_scrollback_view() == 0);
+
+  SECTION("Without a scrollback, the keys for it are left to the program")
+  {
+    auto t2 = remotemo::create(setup(columns, lines));
+    SDL_Event ev {};
+    ev.type = SDL_KEYDOWN;
+    ev.key.state = SDL_PRESSED;
+    ev.key.keysym.mod = static_cast<Uint16>(KMOD_LCTRL | KMOD_LSHIFT);
+    ev.key.keysym.scancode = SDL_SCANCODE_UP;
+    ev.key.keysym.sym = SDLK_UP;
+    SDL_PushEvent(&ev);
+    REQUIRE(t2->get_key() == remotemo::Key::K_up);
+  }
+}
+
+TEST_CASE("Lines already shown get redrawn from the line cache",
+    "[scrollback][stats]")
+{
+  constexpr int columns = 10;
+  constexpr int lines = 3;
+  constexpr int scrollback_lines = 4;
+  auto config = setup(columns, lines);
+  config.scrollback_lines(scrollback_lines).line_cache_lines(2 * lines);
+  REQUIRE(config.text_area().line_cache_lines == 2 * lines);
+  auto t = remotemo::create(config);
+  t->set_text_delay(0);
+  t->print("1\n2\n3\n4\n5\n6");
+
+  REQUIRE(t->set_scrollback_view(scrollback_lines - 1) == 0);
+  REQUIRE(t->set_scrollback_view(0) == 0);
+  t->reset_stats();
+  // All the lines of both views have been shown before:
+  REQUIRE(t->set_scrollback_view(scrollback_lines - 1) == 0);
+  REQUIRE(t->set_scrollback_view(0) == 0);
+  auto stats = t->stats();
+  REQUIRE(stats.line_cache_misses == 0);
+  REQUIRE(stats.line_cache_hits == 2 * lines);
+  // A single copy per line, instead of one per character:
+  REQUIRE(stats.render_copy_calls < 2 * lines * columns);
+  REQUIRE(t->get_char_at({0, 0}) == '4');
+
+  SECTION("The cache is off by default")
+  {
+    auto t2 = remotemo::create(setup(columns, lines));
+    t2->set_text_delay(0);
+    t2->reset_stats();
+    t2->print("1\n2\n3\n4");
+    REQUIRE(t2->stats().line_cache_hits == 0);
+    REQUIRE(t2->stats().line_cache_misses == 0);
+  }
+}
+
+TEST_CASE("Double buffering the text area does not change what is shown",
+    "[capture][print]")
+{
+  const auto capture_dir =
+      std::filesystem::temp_directory_path() / "remotemo_test_buffering";
+  std::filesystem::remove_all(capture_dir);
+  std::filesystem::create_directories(capture_dir);
+  // Returns the last frame presented:
+  auto run = [&capture_dir](bool is_double_buffered) {
+    const auto path_prefix =
+        (capture_dir / (is_double_buffered ? "double" : "single")).string();
+    remotemo::Render_stats stats {};
+    {
+      auto config = setup();
+      config.text_double_buffered(is_double_buffered)
+          .capture_frames(path_prefix, remotemo::Capture_format::raw);
+      auto t = remotemo::create(config);
+      REQUIRE(t.has_value());
+      t->set_text_delay(0);
+      REQUIRE(t->print("Foo") == 0);
+      // Gives the capturing time to catch up, so no frame gets dropped:
+      REQUIRE(t->pause(50) == 0);
+      REQUIRE(t->print_at(1, 1, "Bar") == 0);
+      REQUIRE(t->get_char_at({3, 0}) == ' ');
+      REQUIRE(t->get_char_at({1, 1}) == 'B');
+      stats = t->stats();
+    }
+    REQUIRE(stats.partial_refreshes > 0);
+    REQUIRE(stats.frames_captured > 0);
+    std::ifstream file {path_prefix + ".rgb", std::ios::binary};
+    std::string frames {std::istreambuf_iterator<char> {file},
+        std::istreambuf_iterator<char> {}};
+    auto frame_size = frames.size() / stats.frames_captured;
+    return frames.substr(frames.size() - frame_size);
+  };
+  auto single_buffered = run(false);
+  auto double_buffered = run(true);
+  REQUIRE(!single_buffered.empty());
+  REQUIRE(single_buffered == double_buffered);
+  std::filesystem::remove_all(capture_dir);
+}
+
+TEST_CASE("Everything gets redrawn when the render targets get reset",
+    "[capture][stats]")
+{
+  const auto capture_dir =
+      std::filesystem::temp_directory_path() / "remotemo_test_targets_reset";
+  std::filesystem::remove_all(capture_dir);
+  std::filesystem::create_directories(capture_dir);
+  const auto path_prefix = (capture_dir / "frame").string();
+  const Uint32 event_type = GENERATE(Uint32 {SDL_RENDER_TARGETS_RESET},
+      Uint32 {SDL_RENDER_DEVICE_RESET});
+  Uint64 frames_before_reset {0};
+  remotemo::Render_stats stats {};
+  {
+    auto config = setup();
+    config.text_double_buffered(true).line_cache_lines(4).capture_frames(
+        path_prefix, remotemo::Capture_format::raw);
+    auto t = remotemo::create(config);
+    REQUIRE(t.has_value());
+    t->set_text_delay(0);
+    REQUIRE(t->print("Foo\nBar") == 0);
+    // Gives the capturing time to catch up, so no frame gets dropped:
+    REQUIRE(t->pause(50) == 0);
+    frames_before_reset = t->stats().frames_captured;
+    t->reset_stats();
+    SDL_Event event {};
+    event.type = event_type;
+    SDL_PushEvent(&event);
+    REQUIRE(t->pause(50) == 0);
+    stats = t->stats();
+    REQUIRE(t->get_char_at({2, 0}) == 'o');
+  }
+  REQUIRE(stats.full_refreshes == 1);
+  REQUIRE(stats.partial_refreshes == 0);
+  // The lines got drawn into the atlas again, since it had been emptied:
+  REQUIRE(stats.line_cache_misses > 0);
+  // The frame after the reset looks the same as the last one before it:
+  REQUIRE(frames_before_reset > 0);
+  REQUIRE(stats.frames_captured == 1);
+  std::ifstream file {path_prefix + ".rgb", std::ios::binary};
+  std::string frames {std::istreambuf_iterator<char> {file},
+      std::istreambuf_iterator<char> {}};
+  const auto frame_size = frames.size() / (frames_before_reset + 1);
+  REQUIRE(frames.substr(frames.size() - frame_size) ==
+          frames.substr(frames.size() - 2 * frame_size, frame_size));
+  std::filesystem::remove_all(capture_dir);
+}
+
+TEST_CASE("The text area can be larger than the view of it", "[view]")
+{
+  constexpr int columns = 10;
+  constexpr int lines = 4;
+  constexpr int canvas_columns = 30;
+  constexpr int canvas_lines = 12;
+  auto config = setup(columns, lines);
+  config.text_canvas_size(canvas_columns, canvas_lines);
+  auto t = remotemo::create(config);
+  t->set_text_delay(0);
+
+  // Everything works on the whole canvas, shown or not:
+  REQUIRE(t->print_at(canvas_columns - 3, canvas_lines - 1, "Foo") == 0);
+  REQUIRE(t->get_char_at({canvas_columns - 1, canvas_lines - 1}) == 'o');
+  REQUIRE(t->get_cursor_position().y == canvas_lines);
+
+  REQUIRE(t->get_view_position().x == 0);
+  REQUIRE(t->get_view_position().y == 0);
+  REQUIRE(t->set_view_position(5, 3) == 0);
+  REQUIRE(t->get_view_position().x == 5);
+  REQUIRE(t->get_view_position().y == 3);
+
+  SECTION("Panning by a few whole characters does not redraw everything")
+  {
+    t->reset_stats();
+    REQUIRE(t->set_view_position(6, 2) == 0);
+    auto stats = t->stats();
+    REQUIRE(stats.frames_presented == 1);
+    REQUIRE(stats.full_refreshes == 0);
+  }
+  SECTION("The view can not go outside of the text area")
+  {
+    REQUIRE(t->set_view_position(canvas_columns, -1) == -1);
+    REQUIRE(t->get_view_position().x == canvas_columns - columns);
+    REQUIRE(t->get_view_position().y == 0);
+    REQUIRE(t->set_view_position(0, canvas_lines) == -1);
+    REQUIRE(t->get_view_position().y == canvas_lines - lines);
+  }
+}
+
+TEST_CASE("Printing a few characters only redraws that part of the frame",
+    "[stats][print]")
+{
+  auto config = setup();
+  auto t = remotemo::create(config);
+  t->set_text_delay(0);
+  REQUIRE(t->print("Foo") == 0);
+
+  t->reset_stats();
+  REQUIRE(t->print("Bar") == 0);
+  auto stats = t->stats();
+  REQUIRE(stats.frames_presented > 0);
+  REQUIRE(stats.full_refreshes == 0);
+  REQUIRE(stats.partial_refreshes == stats.frames_presented);
+  REQUIRE(t->get_char_at({3, 0}) == 'B');
+  REQUIRE(t->get_char_at({5, 0}) == 'r');
+}
+
+TEST_CASE("The output can be scaled by whole numbers only", "[scaling]")
+{
+  // A checkered background of 40x30, shown in a window 3.25 times as big
+  // (which gets scaled by 3), 6 pixels in from its top left corner:
+  constexpr int backgr_width = 40;
+  constexpr int backgr_height = 30;
+  constexpr int window_width = 130;
+  constexpr int window_height = 100;
+  constexpr int scale = 3;
+  constexpr int offset = 6;
+  constexpr int bytes_per_pixel = 3;
+  const auto dir =
+      std::filesystem::temp_directory_path() / "remotemo_test_scaling";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  auto is_white_at = [](int x, int y) { return (x + y) % 2 == 0; };
+  const auto backgr_path = (dir / "checkered.png").string();
+  {
+    auto* surface = SDL_CreateRGBSurfaceWithFormat(
+        0, backgr_width, backgr_height, 24, SDL_PIXELFORMAT_RGB24);
+    REQUIRE(surface != nullptr);
+    for (int y = 0; y < backgr_height; y++) {
+      for (int x = 0; x < backgr_width; x++) {
+        auto* pixel = static_cast<Uint8*>(surface->pixels) +
+                      y * surface->pitch + x * bytes_per_pixel;
+        pixel[0] = pixel[1] = pixel[2] = is_white_at(x, y) ? 255 : 0;
+      }
+    }
+    REQUIRE(IMG_SavePNG(surface, backgr_path.c_str()) == 0);
+    SDL_FreeSurface(surface);
+  }
+  const auto path_prefix = (dir / "capture").string();
+  // Small enough for the text to fit in its area without being scaled up:
+  auto config = setup(2, 1);
+  REQUIRE(config.scaling() == remotemo::Scaling_mode::smooth);
+  config.scaling(remotemo::Scaling_mode::integer);
+  REQUIRE(config.scaling() == remotemo::Scaling_mode::integer);
+  config.window_size(window_width, window_height)
+      .background_file_path(backgr_path)
+      .background_min_area(0, 0, backgr_width, backgr_height)
+      .background_text_area(20.0f, 15.0f, 16.0f, 12.0f)
+      .capture_frames(path_prefix, remotemo::Capture_format::raw);
+  bool is_texture = GENERATE(false, true);
+  SDL_Texture* backgr_texture {nullptr};
+  if (is_texture) {
+    REQUIRE(SDL_Init(SDL_INIT_VIDEO) == 0);
+    auto* window = SDL_CreateWindow("", 0, 0, window_width, window_height, 0);
+    REQUIRE(window != nullptr);
+    auto* renderer =
+        SDL_CreateRenderer(window, -1, SDL_RENDERER_TARGETTEXTURE);
+    REQUIRE(renderer != nullptr);
+    backgr_texture = IMG_LoadTexture(renderer, backgr_path.c_str());
+    REQUIRE(backgr_texture != nullptr);
+    // Cleaned up by the library, since cleanup_all is set:
+    config.window(window).background(backgr_texture);
+  }
+  remotemo::Render_stats stats {};
+  {
+    auto t = remotemo::create(config);
+    REQUIRE(t.has_value());
+    t->set_text_delay(0);
+    REQUIRE(t->print("F") == 0);
+    REQUIRE(t->get_char_at({0, 0}) == 'F');
+    stats = t->stats();
+    if (is_texture) {
+      // The texture handed over keeps its own scale mode:
+      SDL_ScaleMode mode {SDL_ScaleModeNearest};
+      REQUIRE(SDL_GetTextureScaleMode(backgr_texture, &mode) == 0);
+      REQUIRE(mode == SDL_ScaleModeLinear);
+    }
+  }
+  REQUIRE(stats.frames_presented > 0);
+  REQUIRE(stats.frames_captured > 0);
+  std::ifstream file {path_prefix + ".rgb", std::ios::binary};
+  std::string frames {std::istreambuf_iterator<char> {file},
+      std::istreambuf_iterator<char> {}};
+  const auto frame_size = frames.size() / stats.frames_captured;
+  REQUIRE(frame_size == static_cast<std::size_t>(
+                            window_width * window_height * bytes_per_pixel));
+  const auto frame = frames.substr(frames.size() - frame_size);
+  // Each pixel of the background (left of the text area) is a block of
+  // 3x3 pixels of exactly its color:
+  for (int y = 0; y < scale * backgr_height; y++) {
+    for (int x = 0; x < scale * 16; x++) {
+      INFO("At (" << x << ", " << y << ")");
+      const auto index = (static_cast<std::size_t>(y + offset) *
+                             window_width + x + offset) *
+                         bytes_per_pixel;
+      const auto red = static_cast<Uint8>(frame[index]);
+      REQUIRE(red == (is_white_at(x / scale, y / scale) ? 255 : 0));
+    }
+  }
+  std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("The renderer can be chosen and what got chosen reported",
+    "[renderer]")
+{
+  auto config = setup();
+  REQUIRE(config.renderer().driver.empty());
+  REQUIRE(config.renderer().is_target_texture_required);
+  config.renderer_driver("software")
+      .renderer_acceleration(remotemo::Renderer_acceleration::software)
+      .renderer_vsync(false);
+  auto t = remotemo::create(config);
+  REQUIRE(t.has_value());
+  auto info = t->renderer_info();
+  REQUIRE(info.has_value());
+  REQUIRE(info->driver == "software");
+  REQUIRE_FALSE(info->is_accelerated);
+  REQUIRE(info->has_target_texture);
+}
+
+TEST_CASE("run() calls the update function at a fixed rate", "[run]")
+{
+  constexpr int steps_per_second = 50;
+  constexpr int steps = 10;
+  auto config = setup();
+  config.clock(remotemo::Clock_mode::simulated);
+  auto t = remotemo::create(config);
+  t->set_text_delay(0);
+  REQUIRE(t->run([](const remotemo::Run_step&) { return false; }, 0) == -1);
+
+  t->reset_stats();
+  std::vector<double> elapsed_ms {};
+  REQUIRE(t->run(
+              [&](const remotemo::Run_step& step) {
+                elapsed_ms.push_back(step.elapsed_ms);
+                REQUIRE(step.number == elapsed_ms.size() - 1);
+                REQUIRE(step.keys.empty());
+                return elapsed_ms.size() < static_cast<std::size_t>(steps);
+              },
+              steps_per_second) == 0);
+  REQUIRE(elapsed_ms.size() == static_cast<std::size_t>(steps));
+  for (std::size_t i = 0; i < elapsed_ms.size(); i++) {
+    auto expected_ms = 1000.0 / steps_per_second * static_cast<double>(i);
+    REQUIRE(std::abs(elapsed_ms[i] - expected_ms) < 0.001);
+  }
+  auto stats = t->stats();
+  REQUIRE(stats.steps_run == steps);
+  REQUIRE(stats.steps_dropped == 0);
+
+  SECTION("Falling far behind drops steps")
+  {
+    int steps_left = 3;
+    REQUIRE(t->run(
+                [&](const remotemo::Run_step&) {
+                  if (steps_left == 3) {
+                    t->pause(1000);
+                  }
+                  return --steps_left > 0;
+                },
+                steps_per_second) == 0);
+    REQUIRE(t->stats().steps_dropped > 0);
+  }
+}
+
+TEST_CASE("Scheduled functions are called when due", "[schedule]")
+{
+  auto config = setup();
+  config.clock(remotemo::Clock_mode::simulated);
+  auto t = remotemo::create(config);
+  t->set_text_delay(0);
+  std::string order {};
+  auto printer = [&t, &order](char character) {
+    return [&t, &order, character]() {
+      order += character;
+      t->print(std::string(1, character));
+    };
+  };
+  REQUIRE(t->schedule(-1, printer('x')) == -1);
+  REQUIRE(t->schedule(30, printer('a')) == 0);
+  REQUIRE(t->schedule(10, [&]() {
+    printer('b')();
+    REQUIRE(t->run_scheduled() == -1);
+    t->schedule(15, printer('c'));
+  }) == 0);
+  REQUIRE(t->schedule(40, []() {
+    push_key({SDL_SCANCODE_A, SDLK_a, remotemo::Key::K_a});
+  }) == 0);
+  remotemo::Key pressed {remotemo::Key::K_0};
+  t->schedule_on_key([&pressed](remotemo::Key key) { pressed = key; });
+
+  REQUIRE(t->run_scheduled() == 0);
+  REQUIRE(order == "bca");
+  REQUIRE(t->get_char_at({0, 0}) == 'b');
+  REQUIRE(t->get_char_at({2, 0}) == 'a');
+  REQUIRE(pressed == remotemo::Key::K_a);
+}
+
+TEST_CASE("The animation of the text being printed can be skipped",
+    "[print][skip]")
+{
+  constexpr int delay_ms = 50;
+  constexpr int skip_after_ms = 100;
+  const std::string text(30, '#');
+  auto config = setup();
+  config.key_skip_animation(remotemo::Mod_keys::None, remotemo::F_key::F5);
+  auto t = remotemo::create(config);
+  t->set_text_delay(delay_ms);
+
+  SECTION("By pressing the key")
+  {
+    std::thread press_later {delayed_key_press, skip_after_ms,
+        Get_key_test_param {SDL_SCANCODE_F5, SDLK_F5, remotemo::Key::K_0}};
+    auto start = std::chrono::steady_clock::now();
+    REQUIRE(t->print(text) == 0);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    press_later.join();
+    REQUIRE(elapsed < std::chrono::milliseconds {delay_ms * 15});
+  }
+  SECTION("Through a handle")
+  {
+    auto handle = t->handle();
+    std::thread skip_later {[handle, skip_after_ms]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds {skip_after_ms});
+      handle.skip_animation();
+    }};
+    auto start = std::chrono::steady_clock::now();
+    REQUIRE(t->print(text) == 0);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    skip_later.join();
+    REQUIRE(elapsed < std::chrono::milliseconds {delay_ms * 15});
+  }
+  // All of it got printed, and the next print is animated again:
+  REQUIRE(t->get_char_at({29, 0}) == '#');
+  REQUIRE(t->get_cursor_position().x == 30);
+  auto start = std::chrono::steady_clock::now();
+  REQUIRE(t->print("ab") == 0);
+  REQUIRE(std::chrono::steady_clock::now() - start >=
+          std::chrono::milliseconds {delay_ms});
+}
+
+TEST_CASE("Escape sequences can be printed, when asked for",
+    "[print][inverse]")
+{
+  constexpr int columns = 10;
+  constexpr int lines = 4;
+  auto config = setup(columns, lines);
+  auto t = remotemo::create(config);
+  t->set_text_delay(0);
+  REQUIRE_FALSE(t->get_escape_sequences());
+  t->set_escape_sequences(true);
+  REQUIRE(t->get_escape_sequences());
+
+  REQUIRE(t->print("\x1b[2;3HAb\x1b[7mC\x1b[mD") == 0);
+  REQUIRE(t->get_char_at({2, 1}) == 'A');
+  REQUIRE(t->get_char_at({3, 1}) == 'b');
+  REQUIRE(t->get_char_at({4, 1}) == 'C');
+  REQUIRE(t->is_inverse_at({4, 1}));
+  REQUIRE(t->get_char_at({5, 1}) == 'D');
+  REQUIRE_FALSE(t->is_inverse_at({5, 1}));
+  REQUIRE(t->get_cursor_position().x == 6);
+  REQUIRE(t->get_cursor_position().y == 1);
+
+  SECTION("Moving the cursor")
+  {
+    REQUIRE(t->print("\x1b[A\x1b[3D") == 0);
+    REQUIRE(t->get_cursor_position().x == 3);
+    REQUIRE(t->get_cursor_position().y == 0);
+    // Never past the border:
+    REQUIRE(t->print("\x1b[99B\x1b[99C\x1b[99;99f") == 0);
+    REQUIRE(t->get_cursor_position().x == columns - 1);
+    REQUIRE(t->get_cursor_position().y == lines - 1);
+    REQUIRE(t->print("\x1b[H\r") == 0);
+    REQUIRE(t->get_cursor_position().x == 0);
+    REQUIRE(t->get_cursor_position().y == 0);
+  }
+  SECTION("Erasing")
+  {
+    REQUIRE(t->print("\x1b[2;4H\x1b[K") == 0);
+    REQUIRE(t->get_char_at({2, 1}) == 'A');
+    REQUIRE(t->get_char_at({3, 1}) == ' ');
+    REQUIRE(t->get_char_at({5, 1}) == ' ');
+    // Modes other than 0, 1 and 2 erase nothing:
+    REQUIRE(t->print("\x1b[1;1Hxyz\x1b[3J\x1b[3K") == 0);
+    REQUIRE(t->get_char_at({0, 0}) == 'x');
+    REQUIRE(t->get_char_at({2, 0}) == 'z');
+    REQUIRE(t->get_char_at({2, 1}) == 'A');
+    REQUIRE(t->print("\x1b[2J") == 0);
+    REQUIRE(t->get_char_at({0, 0}) == ' ');
+    REQUIRE(t->get_char_at({2, 1}) == ' ');
+    // The cursor does not move:
+    REQUIRE(t->get_cursor_position().x == 3);
+    // What gets erased is not inversed, even while printing inversed:
+    REQUIRE(t->print("\x1b[7mxyz\x1b[2D\x1b[K") == 0);
+    REQUIRE(t->get_char_at({3, 0}) == 'x');
+    REQUIRE(t->is_inverse_at({3, 0}));
+    REQUIRE(t->get_char_at({4, 0}) == ' ');
+    REQUIRE_FALSE(t->is_inverse_at({4, 0}));
+  }
+  SECTION("A sequence can be split and unsupported ones are dropped")
+  {
+    REQUIRE(t->print("\x1b[") == 0);
+    REQUIRE(t->print("4;2H\x1b[?25lE") == 0);
+    REQUIRE(t->get_char_at({1, 3}) == 'E');
+    REQUIRE(t->get_cursor_position().x == 2);
+    // A '[' within a sequence makes it invalid, so it is ignored up to its
+    // final character:
+    REQUIRE(t->print("\x1b[1[Xy") == 0);
+    REQUIRE(t->get_char_at({2, 3}) == 'y');
+    REQUIRE(t->get_cursor_position().x == 3);
+  }
+  SECTION("Only the scroll region scrolls")
+  {
+    REQUIRE(t->print("\x1b[1;1HTop\x1b[4;1HBottom") == 0);
+    REQUIRE(t->print("\x1b[2;3r\x1b[3;1H1\n2") == 0);
+    REQUIRE(t->get_char_at({0, 0}) == 'T');
+    REQUIRE(t->get_char_at({0, 1}) == '1');
+    REQUIRE(t->get_char_at({0, 2}) == '2');
+    REQUIRE(t->get_char_at({0, 3}) == 'B');
+    REQUIRE(t->get_scrollback_size() == 0);
+  }
+  SECTION("When not asked for, the escape character is printed as is")
+  {
+    t->set_escape_sequences(false);
+    REQUIRE(t->print("\x1b[m") == 0);
+    REQUIRE(t->get_char_at({7, 1}) == '[');
+  }
+}
+
+TEST_CASE("Text can be printed from streams and files", "[print][stats]")
+{
+  constexpr int columns = 12;
+  constexpr int lines = 3;
+  constexpr int scrollback_lines = 5;
+  constexpr int input_lines = 20000;
+  auto config = setup(columns, lines);
+  config.scrollback_lines(scrollback_lines);
+  auto t = remotemo::create(config);
+  t->set_text_delay(0);
+  std::stringstream input {};
+  for (int i = 0; i < input_lines; i++) {
+    input << "Line " << i << '\n';
+  }
+
+  t->reset_stats();
+  REQUIRE(t->print_stream(input) == 0);
+  std::string last_line {};
+  for (int column = 0; column < columns; column++) {
+    last_line += t->get_char_at({column, lines - 1});
+  }
+  REQUIRE(last_line == "Line 19999  ");
+  // The last line ended with a newline, so the cursor is below it:
+  REQUIRE(t->get_cursor_position().y == lines);
+  REQUIRE(t->get_scrollback_size() == scrollback_lines);
+  // Far from one frame per character (or per line):
+  REQUIRE(t->stats().frames_presented < 10);
+
+  SECTION("From a file")
+  {
+    const auto file_path =
+        (std::filesystem::temp_directory_path() / "remotemo_test_print.txt")
+            .string();
+    {
+      std::ofstream file {file_path};
+      file << "Foo\nBar";
+    }
+    REQUIRE(t->print_file(file_path) == 0);
+    REQUIRE(t->get_char_at({0, lines - 2}) == 'F');
+    REQUIRE(t->get_char_at({2, lines - 1}) == 'r');
+    std::filesystem::remove(file_path);
+    REQUIRE(t->print_file(file_path) == -1);
+  }
+  SECTION("Stops when something can not get displayed")
+  {
+    t->set_wrapping(remotemo::Wrapping::off);
+    std::stringstream too_long {"0123456789ABC\nnot read"};
+    REQUIRE(t->print_stream(too_long) == -2);
+  }
+}
+
+TEST_CASE("Printing runs of characters at once gives the same result",
+    "[print]")
+{
+  constexpr int columns = 13;
+  constexpr int lines = 4;
+  std::string text {};
+  for (int i = 0; i < 3; i++) {
+    text += "The quick brown fox jumps over the lazy dog.\n";
+    text += "Tab\there, bell\a, backspace\b and \xc3\xa9t\xc3\xa9.";
+    text += std::string(columns, '=') + "x\n";
+  }
+  auto config = setup(columns, lines);
+  // Character by character:
+  auto expected = remotemo::create(config);
+  expected->set_text_delay(0);
+  expected->set_inverse(true);
+  REQUIRE(expected->print(text) == 0);
+  // In runs, which is what printing a stream with no delay does:
+  auto t = remotemo::create(config);
+  t->set_text_delay(0);
+  t->set_inverse(true);
+  std::stringstream input {text};
+  REQUIRE(t->print_stream(input) == 0);
+
+  REQUIRE(t->get_cursor_position().x == expected->get_cursor_position().x);
+  REQUIRE(t->get_cursor_position().y == expected->get_cursor_position().y);
+  for (int line = 0; line < lines; line++) {
+    for (int column = 0; column < columns; column++) {
+      INFO("At " << column << ", " << line);
+      REQUIRE(t->get_char_at({column, line}) ==
+              expected->get_char_at({column, line}));
+      REQUIRE(t->is_inverse_at({column, line}) ==
+              expected->is_inverse_at({column, line}));
+    }
+  }
+}
+
+TEST_CASE("UTF-8 text is decoded and shown with the pages of the font",
+    "[print][utf8]")
+{
+  constexpr int columns = 10;
+  constexpr int lines = 2;
+  auto config = setup(columns, lines);
+  SECTION("The default font only has ASCII")
+  {
+    auto t = remotemo::create(config);
+    t->set_text_delay(0);
+    REQUIRE(t->print("a\xc3\xa9z") == 0);
+    REQUIRE(t->get_char_at({1, 0}) == 1);
+    REQUIRE(t->get_code_point_at({1, 0}) == 0xfffd);
+    REQUIRE(t->get_code_point_at({2, 0}) == 'z');
+    REQUIRE(t->get_cursor_position().x == 3);
+  }
+  SECTION("A font with the Latin-1 page")
+  {
+    const auto font_path =
+        (std::filesystem::temp_directory_path() / "remotemo_test_font.png")
+            .string();
+    save_blank_font(font_path, 2);
+    config.font_bitmap_file_path(font_path);
+    auto t = remotemo::create(config);
+    std::filesystem::remove(font_path);
+    REQUIRE(t);
+    t->set_text_delay(0);
+
+    REQUIRE(t->print("\xc3\xa9t\xc3\xa9") == 0);
+    REQUIRE(t->get_code_point_at({0, 0}) == 0xe9);
+    REQUIRE(t->get_char_at({0, 0}) == 1);
+    REQUIRE(t->get_code_point_at({1, 0}) == 't');
+    REQUIRE(t->get_code_point_at({2, 0}) == 0xe9);
+    // Box drawing is not in this font:
+    REQUIRE(t->print("\xe2\x94\x80") == 0);
+    REQUIRE(t->get_code_point_at({3, 0}) == 0xfffd);
+    // A character split between two prints:
+    REQUIRE(t->print("\xc2") == 0);
+    REQUIRE(t->get_cursor_position().x == 4);
+    REQUIRE(t->print("\xb0") == 0);
+    REQUIRE(t->get_code_point_at({4, 0}) == 0xb0);
+    // Invalid sequences take up one square each:
+    REQUIRE(t->print("\xff\xc0\xafz") == 0);
+    REQUIRE(t->get_code_point_at({5, 0}) == 0xfffd);
+    REQUIRE(t->get_code_point_at({6, 0}) == 0xfffd);
+    REQUIRE(t->get_code_point_at({7, 0}) == 'z');
+  }
+}
+
+TEST_CASE("A font bitmap without the inversed glyphs gets them made",
+    "[capture][print][inverse]")
+{
+  constexpr int char_width = 7;
+  constexpr int char_height = 18;
+  constexpr int glyph_rows = 8;
+  const auto dir =
+      std::filesystem::temp_directory_path() / "remotemo_test_inverse";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  // With a background that is transparent (rather than black) in parts, the
+  // inversed glyphs still have to be opaque, with that background lit:
+  const bool is_transparent = GENERATE(false, true);
+  // Saves a font with some pattern as its glyphs, and with or without the
+  // inversed glyphs below them:
+  auto save_font = [&dir, is_transparent](bool has_inverse) {
+    const int height = glyph_rows * char_height;
+    auto* surface = SDL_CreateRGBSurfaceWithFormat(0, 16 * char_width,
+        has_inverse ? 2 * height : height, 32, SDL_PIXELFORMAT_RGBA32);
+    REQUIRE(surface != nullptr);
+    for (int y = 0; y < height; y++) {
+      for (int x = 0; x < surface->w; x++) {
+        auto value = static_cast<Uint8>((x * 7 + y * 13) % 256);
+        auto alpha = static_cast<Uint8>(
+            is_transparent && (x + y) % 3 == 0 ? 0 : 255);
+        auto* pixels = static_cast<Uint8*>(surface->pixels);
+        auto* pixel = pixels + y * surface->pitch + x * 4;
+        pixel[0] = pixel[1] = pixel[2] = value;
+        pixel[3] = alpha;
+        if (has_inverse) {
+          auto* inversed = pixel + height * surface->pitch;
+          inversed[0] = inversed[1] = inversed[2] =
+              static_cast<Uint8>(255 - value * alpha / 255);
+          inversed[3] = 255;
+        }
+      }
+    }
+    auto path = (dir / (has_inverse ? "full.png" : "half.png")).string();
+    REQUIRE(IMG_SavePNG(surface, path.c_str()) == 0);
+    SDL_FreeSurface(surface);
+    return path;
+  };
+  // Returns the last frame presented, with the font either loaded from the
+  // file or handed over as a texture:
+  auto run = [](const std::string& font_path, bool is_texture = false) {
+    const auto path_prefix = font_path + ".capture";
+    remotemo::Render_stats stats {};
+    {
+      auto config = setup();
+      config.font_bitmap_file_path(font_path)
+          .capture_frames(path_prefix, remotemo::Capture_format::raw);
+      if (is_texture) {
+        REQUIRE(SDL_Init(SDL_INIT_VIDEO) == 0);
+        const auto& window_config = config.window();
+        auto* window = SDL_CreateWindow(window_config.title.c_str(),
+            window_config.pos_x, window_config.pos_y, window_config.width,
+            window_config.height, SDL_WINDOW_RESIZABLE);
+        REQUIRE(window != nullptr);
+        auto* renderer =
+            SDL_CreateRenderer(window, -1, SDL_RENDERER_TARGETTEXTURE);
+        REQUIRE(renderer != nullptr);
+        auto* texture = IMG_LoadTexture(renderer, font_path.c_str());
+        REQUIRE(texture != nullptr);
+        // Cleaned up by the library, since cleanup_all is set:
+        config.window(window).font_bitmap(texture);
+      }
+      auto t = remotemo::create(config);
+      REQUIRE(t.has_value());
+      t->set_text_delay(0);
+      t->set_inverse(true);
+      REQUIRE(t->print("Foo ") == 0);
+      t->set_inverse(false);
+      REQUIRE(t->print("bar") == 0);
+      REQUIRE(t->pause(50) == 0);
+      stats = t->stats();
+    }
+    REQUIRE(stats.frames_captured > 0);
+    std::ifstream file {path_prefix + ".rgb", std::ios::binary};
+    std::string frames {std::istreambuf_iterator<char> {file},
+        std::istreambuf_iterator<char> {}};
+    auto frame_size = frames.size() / stats.frames_captured;
+    return frames.substr(frames.size() - frame_size);
+  };
+  auto stored = run(save_font(true));
+  REQUIRE(!stored.empty());
+  SECTION("When loading the font bitmap") {
+    REQUIRE(stored == run(save_font(false)));
+  }
+  SECTION("When handed a texture without them") {
+    REQUIRE(stored == run(save_font(false), true));
+  }
+  std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("Console fonts can be used instead of a font bitmap", "[font]")
+{
+  constexpr int columns = 10;
+  constexpr int lines = 2;
+  const auto dir = std::filesystem::temp_directory_path() / "remotemo_fonts";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  auto config = setup(columns, lines);
+  auto create_with = [&config, &dir](
+                         const std::string& file_name, std::string content) {
+    auto path = (dir / file_name).string();
+    {
+      std::ofstream file {path, std::ios::binary};
+      file << content;
+    }
+    config.font_psf_file(path);
+    return remotemo::create(config);
+  };
+
+  SECTION("PSF (version 2), with a Unicode table")
+  {
+    constexpr int glyph_count = 3;
+    constexpr int glyph_height = 16;
+    auto header = [](std::string* psf, std::uint32_t value) {
+      for (int i = 0; i < 4; i++) {
+        psf->push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+      }
+    };
+    std::string psf {"\x72\xb5\x4a\x86"};
+    for (std::uint32_t value :
+        {0U, 32U, 1U, std::uint32_t {glyph_count}, 16U, 16U, 8U}) {
+      header(&psf, value);
+    }
+    psf += std::string(glyph_count * glyph_height, '\x5a');
+    psf += "A\xff\xc3\xa9\xfe\x65\xcc\x81\xff\xe2\x94\x80\xff";
+    auto t = create_with("font.psf", psf);
+    REQUIRE(t.has_value());
+    t->set_text_delay(0);
+    REQUIRE(t->print("A\xc3\xa9\xe2\x94\x80" "B\xe2\x96\x80") == 0);
+    REQUIRE(t->get_code_point_at({0, 0}) == 'A');
+    REQUIRE(t->get_code_point_at({1, 0}) == 0xe9);
+    REQUIRE(t->get_code_point_at({2, 0}) == 0x2500);
+    REQUIRE(t->get_code_point_at({3, 0}) == 'B');
+    // Only the pages up to the one with box drawing are there:
+    REQUIRE(t->get_code_point_at({4, 0}) == 0xfffd);
+  }
+  SECTION("BDF")
+  {
+    auto t = create_with("font.bdf",
+        "STARTFONT 2.1\n"
+        "FONT -test-font\n"
+        "FONTBOUNDINGBOX 6 10 0 -2\n"
+        "CHARS 2\n"
+        "STARTCHAR A\nENCODING 65\nBBX 5 3 0 0\nBITMAP\n"
+        "70\n88\nF8\nENDCHAR\n"
+        "STARTCHAR unencoded\nENCODING -1\nBBX 5 1 0 0\nBITMAP\n"
+        "F8\nENDCHAR\n"
+        "ENDFONT\n");
+    REQUIRE(t.has_value());
+    t->set_text_delay(0);
+    REQUIRE(t->print("A\xc3\xa9") == 0);
+    REQUIRE(t->get_code_point_at({0, 0}) == 'A');
+    REQUIRE(t->get_code_point_at({1, 0}) == 0xfffd);
+  }
+  SECTION("The cursor gets shown, though the font has no glyph for it")
+  {
+    const std::string bdf {"STARTFONT 2.1\n"
+                           "FONTBOUNDINGBOX 6 10 0 -2\n"
+                           "STARTCHAR A\nENCODING 65\nBBX 5 3 0 0\nBITMAP\n"
+                           "70\n88\nF8\nENDCHAR\n"
+                           "ENDFONT\n"};
+    // Returns the last frame presented:
+    auto last_frame = [&](const remotemo::Point& cursor) {
+      const auto path_prefix = (dir / "capture").string();
+      config.capture_frames(path_prefix, remotemo::Capture_format::raw);
+      remotemo::Render_stats stats {};
+      {
+        auto t = create_with("font.bdf", bdf);
+        REQUIRE(t.has_value());
+        REQUIRE(t->set_cursor(cursor) == 0);
+        // Gives the capturing time to catch up:
+        REQUIRE(t->pause(50) == 0);
+        stats = t->stats();
+      }
+      REQUIRE(stats.frames_captured > 0);
+      std::ifstream file {path_prefix + ".rgb", std::ios::binary};
+      std::string frames {std::istreambuf_iterator<char> {file},
+          std::istreambuf_iterator<char> {}};
+      auto frame_size = frames.size() / stats.frames_captured;
+      return frames.substr(frames.size() - frame_size);
+    };
+    // With an empty cursor, both would be blank:
+    REQUIRE(last_frame({0, 0}) != last_frame({3, 1}));
+  }
+  SECTION("Not a font")
+  {
+    REQUIRE(!create_with("font.txt", "Not a font\n").has_value());
+    REQUIRE(!create_with("truncated.psf", "\x72\xb5\x4a\x86\x00\x00")
+                 .has_value());
+    config.font_psf_file((dir / "missing.psf").string());
+    REQUIRE(!remotemo::create(config).has_value());
+  }
+  std::filesystem::remove_all(dir);
+}
+
 TEST_CASE("The 'inverse' setting should affect printing", "[print][inverse]")
 {
   constexpr int columns = 20;
@@ -754,7 +2019,15 @@ TEST_CASE("The 'inverse' setting should affect printing", "[print][inverse]")
   const std::string empty_line(columns, ' ');
   const std::deque<bool> normal_line(columns, false);
   auto config = setup(columns, lines);
+  // With the Latin-1 page, for printing non-ASCII characters:
+  const auto font_path =
+      (std::filesystem::temp_directory_path() / "remotemo_test_print.png")
+          .string();
+  save_blank_font(font_path, 2);
+  config.font_bitmap_file_path(font_path);
   auto eng = remotemo::Engine::create(config);
+  std::filesystem::remove(font_path);
+  REQUIRE(eng);
   auto* engine = eng.get();
   remotemo::Remotemo t = remotemo::create_remotemo(std::move(eng), config);
   t.set_text_delay(0);
@@ -857,7 +2130,15 @@ TEST_CASE("Inversed content should scroll the same way as the text",
   const std::string empty_line(columns, ' ');
   const std::deque<bool> normal_line(columns, false);
   auto config = setup(columns, lines);
+  // With the Latin-1 page, for printing non-ASCII characters:
+  const auto font_path =
+      (std::filesystem::temp_directory_path() / "remotemo_test_print.png")
+          .string();
+  save_blank_font(font_path, 2);
+  config.font_bitmap_file_path(font_path);
   auto eng = remotemo::Engine::create(config);
+  std::filesystem::remove(font_path);
+  REQUIRE(eng);
   auto* engine = eng.get();
   remotemo::Remotemo t = remotemo::create_remotemo(std::move(eng), config);
   t.set_text_delay(0);